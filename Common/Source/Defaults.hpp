@@ -30,6 +30,7 @@ static const String KNOWN_PLUGINS_FILE = "~/.audiogridder/audiogridderserver.cac
 static const String DEAD_MANS_FILE = "~/.audiogridder/audiogridderserver.crash";
 static const String SERVER_RUN_FILE = "~/.audiogridder/audiogridderserver.running";
 static const String WINDOW_POSITIONS_FILE = "~/.audiogridder/audiogridder.winpos";
+static const String PARAMS_CACHE_DIR = "~/.audiogridder/paramcache";
 #else
 static const String SERVER_CONFIG_FILE_OLD =
     File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() + "\\.audiogridderserver";
@@ -54,6 +55,8 @@ static const String SERVER_RUN_FILE = File::getSpecialLocation(File::userApplica
 static const String WINDOW_POSITIONS_FILE =
     File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
     "\\AudioGridder\\audiogridder.winpos";
+static const String PARAMS_CACHE_DIR = File::getSpecialLocation(File::userApplicationDataDirectory).getFullPathName() +
+                                       "\\AudioGridder\\paramcache";
 #endif
 
 setLogTagStatic("defaults");
@@ -121,8 +124,18 @@ inline String getConfigFileName(ConfigFile type) {
 }
 
 static constexpr int DEFAULT_NUM_OF_BUFFERS = 8;
+static constexpr int DEFAULT_NETWORK_FRAME_SIZE = 0;
+static constexpr float DEFAULT_SILENCE_THRESHOLD_DB = -120.0f;
+static constexpr int NUM_OF_SHARED_BUSES = 8;
+static constexpr int NUM_OF_SIDECHAIN_SOURCES = 8;
 static constexpr int DEFAULT_NUM_RECENTS = 10;
 static constexpr int DEFAULT_LOAD_PLUGIN_TIMEOUT = 15000;
+static constexpr int MAX_PARALLEL_GROUPS = 4;
+static constexpr int MAX_PARALLEL_BRANCHES = 4;
+static constexpr int DEFAULT_PLUGIN_LOADER_WORKERS = 4;
+static constexpr int PLUGIN_POOL_MAX_SIZE = 4;
+static constexpr int PLUGIN_POOL_MAX_ENTRIES = 32;
+static constexpr int PLUGIN_POOL_EXPIRE_MS = 600000;
 
 static constexpr uint32 BG_COLOR = 0xff222222;
 static constexpr uint32 BUTTON_COLOR = 0xff333333;
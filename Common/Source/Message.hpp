@@ -93,12 +93,31 @@ struct Handshake {
     uint8 flags;
     uint8 unused1;
     uint16 unused2;
-    uint32 unused3;
+    uint32 capabilities;  // since version 3
     uint32 unused4;
 
+    static constexpr int VERSION = 3;
+
     enum FLAGS : uint8 { NO_PLUGINLIST_FILTER = 1 };
     void setFlag(uint8 f) { flags |= f; }
     bool isFlag(uint8 f) { return (flags & f) == f; }
+
+    // Protocol extensions, that need support on both sides. A server answers a handshake of version 3 or newer with
+    // its capabilities (see Capabilities message) before sending the plugin list. A connection only uses the
+    // extensions, that both sides support, and falls back to the old messages otherwise.
+    enum CAPABILITIES : uint32 {
+        CAP_SILENT_CHANNELS = 1 << 0,   // audio headers with silent channel flags
+        CAP_PARAMETER_CACHE = 1 << 1,   // json AddPlugin, versioned Parameters and Parameters requests
+        CAP_SETTINGS_HASH = 1 << 2,     // PluginSettingsHash, PluginSettingsDelta and GetChangedPluginSettings
+        CAP_PARAMETER_VALUES = 1 << 3,  // ParameterValues and SubscribeParameters
+        CAP_PLUGIN_STATS = 1 << 4,
+        CAP_OVERLOAD_EVENTS = 1 << 5,
+        CAP_LOAD_CHAIN = 1 << 6,
+        CAP_MOUSE_EVENTS = 1 << 7,
+        CAP_PARALLEL = 1 << 8,  // SetParallelBranch and SetParallelDry
+        CAP_BUSES = 1 << 9,     // SetBus and SetSidechain
+        CAP_ALL = (1 << 10) - 1
+    };
 };
 
 /*
@@ -106,7 +125,9 @@ struct Handshake {
  */
 class AudioMessage : public LogTagDelegate {
   public:
-    AudioMessage(const LogTag* tag) : LogTagDelegate(tag) {}
+    // Peers without the CAP_SILENT_CHANNELS capability use the headers without the silentChannels field
+    AudioMessage(const LogTag* tag, bool silentChannels = true)
+        : LogTagDelegate(tag), m_silentChannelsSupported(silentChannels) {}
 
     struct RequestHeader {
         int channels;
@@ -115,6 +136,7 @@ class AudioMessage : public LogTagDelegate {
         int samplesRequested;   // If only midi data is sent, let the server know about the expected audio buffer size
         int numMidiEvents;
         bool isDouble;
+        uint64 silentChannels;  // One bit per channel, the data of silent channels is not sent
     };
 
     struct ResponseHeader {
@@ -122,6 +144,7 @@ class AudioMessage : public LogTagDelegate {
         int samples;
         int numMidiEvents;
         int latencySamples;
+        uint64 silentChannels;
     };
 
     struct MidiHeader {
@@ -135,12 +158,40 @@ class AudioMessage : public LogTagDelegate {
     int getSamplesRequested() const { return m_reqHeader.samplesRequested; }
     bool isDouble() const { return m_reqHeader.isDouble; }
 
+    // True if all channels of the request are silent and no midi has been sent
+    bool isSilent() const {
+        return m_reqHeader.numMidiEvents == 0 && allChannelsSilent(m_reqHeader.silentChannels, m_reqHeader.channels);
+    }
+
+    // True if all channels of the last response have been silent and no midi has been sent
+    bool isResponseSilent() const {
+        return m_resHeader.numMidiEvents == 0 && allChannelsSilent(m_resHeader.silentChannels, m_resHeader.channels);
+    }
+
+    static bool isChannelSilent(uint64 silentChannels, int chan) {
+        return chan < 64 && (silentChannels & ((uint64)1 << chan)) != 0;
+    }
+
+    // Flags all channels with a magnitude not above threshold as silent, a negative threshold disables the detection
+    template <typename T>
+    static uint64 getSilentChannels(const AudioBuffer<T>& buffer, int channels, T threshold) {
+        uint64 silentChannels = 0;
+        if (threshold >= 0) {
+            for (int chan = 0; chan < jmin(channels, 64); ++chan) {
+                if (buffer.getMagnitude(chan, 0, buffer.getNumSamples()) <= threshold) {
+                    silentChannels |= (uint64)1 << chan;
+                }
+            }
+        }
+        return silentChannels;
+    }
+
     int getLatencySamples() const { return m_resHeader.latencySamples; }
 
     template <typename T>
     bool sendToServer(StreamingSocket* socket, AudioBuffer<T>& buffer, MidiBuffer& midi,
                       AudioPlayHead::CurrentPositionInfo& posInfo, int channelsRequested, int samplesRequested,
-                      MessageHelper::Error* e, Meter& metric) {
+                      T silenceThreshold, MessageHelper::Error* e, Meter& metric) {
         traceScope();
         m_reqHeader.channels = buffer.getNumChannels();
         m_reqHeader.samples = buffer.getNumSamples();
@@ -148,11 +199,16 @@ class AudioMessage : public LogTagDelegate {
         m_reqHeader.samplesRequested = samplesRequested > -1 ? samplesRequested : buffer.getNumSamples();
         m_reqHeader.isDouble = std::is_same<T, double>::value;
         m_reqHeader.numMidiEvents = midi.getNumEvents();
+        m_reqHeader.silentChannels =
+            m_silentChannelsSupported ? getSilentChannels(buffer, m_reqHeader.channels, silenceThreshold) : 0;
         if (socket->isConnected()) {
-            if (!send(socket, reinterpret_cast<const char*>(&m_reqHeader), sizeof(m_reqHeader), e, &metric)) {
+            if (!send(socket, reinterpret_cast<const char*>(&m_reqHeader), getRequestHeaderSize(), e, &metric)) {
                 return false;
             }
             for (int chan = 0; chan < m_reqHeader.channels; ++chan) {
+                if (isChannelSilent(m_reqHeader.silentChannels, chan)) {
+                    continue;
+                }
                 if (!send(socket, reinterpret_cast<const char*>(buffer.getReadPointer(chan)),
                           m_reqHeader.samples * as<int>(sizeof(T)), e, &metric)) {
                     return false;
@@ -184,11 +240,16 @@ class AudioMessage : public LogTagDelegate {
         m_resHeader.samples = buffer.getNumSamples();
         m_resHeader.latencySamples = latencySamples;
         m_resHeader.numMidiEvents = midi.getNumEvents();
+        // only flag digital silence in the response
+        m_resHeader.silentChannels = m_silentChannelsSupported ? getSilentChannels(buffer, channelsToSend, (T)0) : 0;
         if (socket->isConnected()) {
-            if (!send(socket, reinterpret_cast<const char*>(&m_resHeader), sizeof(m_resHeader), e, &metric)) {
+            if (!send(socket, reinterpret_cast<const char*>(&m_resHeader), getResponseHeaderSize(), e, &metric)) {
                 return false;
             }
             for (int chan = 0; chan < m_resHeader.channels; ++chan) {
+                if (isChannelSilent(m_resHeader.silentChannels, chan)) {
+                    continue;
+                }
                 if (!send(socket, reinterpret_cast<const char*>(buffer.getReadPointer(chan)),
                           m_resHeader.samples * as<int>(sizeof(T)), e, &metric)) {
                     return false;
@@ -214,7 +275,8 @@ class AudioMessage : public LogTagDelegate {
                         Meter& metric) {
         traceScope();
         if (socket->isConnected()) {
-            if (!read(socket, &m_resHeader, sizeof(m_resHeader), 1000, e, &metric)) {
+            m_resHeader.silentChannels = 0;
+            if (!read(socket, &m_resHeader, getResponseHeaderSize(), 1000, e, &metric)) {
                 MessageHelper::seterrstr(e, "response header");
                 return false;
             }
@@ -227,6 +289,10 @@ class AudioMessage : public LogTagDelegate {
                 return false;
             }
             for (int chan = 0; chan < buffer.getNumChannels(); ++chan) {
+                if (isChannelSilent(m_resHeader.silentChannels, chan)) {
+                    buffer.clear(chan, 0, buffer.getNumSamples());
+                    continue;
+                }
                 if (!read(socket, buffer.getWritePointer(chan), buffer.getNumSamples() * as<int>(sizeof(T)), 1000, e,
                           &metric)) {
                     MessageHelper::seterrstr(e, "audio data");
@@ -277,7 +343,8 @@ class AudioMessage : public LogTagDelegate {
                         MessageHelper::Error* e, Meter& metric) {
         traceScope();
         if (socket->isConnected()) {
-            if (!read(socket, &m_reqHeader, sizeof(m_reqHeader), 0, e, &metric)) {
+            m_reqHeader.silentChannels = 0;
+            if (!read(socket, &m_reqHeader, getRequestHeaderSize(), 0, e, &metric)) {
                 MessageHelper::seterrstr(e, "request header");
                 return false;
             }
@@ -293,6 +360,14 @@ class AudioMessage : public LogTagDelegate {
             }
             // Read the channel data from the client, if any
             for (int chan = 0; chan < m_reqHeader.channels; ++chan) {
+                if (isChannelSilent(m_reqHeader.silentChannels, chan)) {
+                    if (m_reqHeader.isDouble) {
+                        bufferD.clear(chan, 0, totalSamples);
+                    } else {
+                        bufferF.clear(chan, 0, totalSamples);
+                    }
+                    continue;
+                }
                 char* data = m_reqHeader.isDouble ? reinterpret_cast<char*>(bufferD.getWritePointer(chan))
                                                   : reinterpret_cast<char*>(bufferF.getWritePointer(chan));
                 if (!read(socket, data, size, 0, e, &metric)) {
@@ -331,6 +406,24 @@ class AudioMessage : public LogTagDelegate {
   private:
     RequestHeader m_reqHeader;
     ResponseHeader m_resHeader;
+    bool m_silentChannelsSupported;
+
+    // The silentChannels field is the last one, so the old headers are the new ones without it
+    int getRequestHeaderSize() const {
+        return m_silentChannelsSupported ? (int)sizeof(RequestHeader) : (int)offsetof(RequestHeader, silentChannels);
+    }
+
+    int getResponseHeaderSize() const {
+        return m_silentChannelsSupported ? (int)sizeof(ResponseHeader) : (int)offsetof(ResponseHeader, silentChannels);
+    }
+
+    static bool allChannelsSilent(uint64 silentChannels, int channels) {
+        if (channels > 64) {
+            return false;
+        }
+        uint64 all = channels < 64 ? ((uint64)1 << channels) - 1 : ~(uint64)0;
+        return (silentChannels & all) == all;
+    }
 };
 
 /*
@@ -516,10 +609,10 @@ class PluginList : public StringPayload {
     PluginList() : StringPayload(Type) {}
 };
 
-class AddPlugin : public StringPayload {
+class AddPlugin : public JsonPayload {
   public:
     static constexpr int Type = __COUNTER__;
-    AddPlugin() : StringPayload(Type) {}
+    AddPlugin() : JsonPayload(Type) {}
 };
 
 class DelPlugin : public NumberPayload {
@@ -724,6 +817,123 @@ class CPULoad : public FloatPayload {
     CPULoad() : FloatPayload(Type) {}
 };
 
+struct parallelbranch_t {
+    int idx;
+    int group;
+    int branch;
+};
+
+class SetParallelBranch : public DataPayload<parallelbranch_t> {
+  public:
+    static constexpr int Type = __COUNTER__;
+    SetParallelBranch() : DataPayload<parallelbranch_t>(Type) {}
+};
+
+class PluginStats : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    PluginStats() : JsonPayload(Type) {}
+};
+
+class SetBus : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    SetBus() : JsonPayload(Type) {}
+};
+
+class SetSidechain : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    SetSidechain() : JsonPayload(Type) {}
+};
+
+class OverloadEvents : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    OverloadEvents() : JsonPayload(Type) {}
+};
+
+// Requests the settings of a plugin, if they differ from the settings with the given hash
+class GetChangedPluginSettings : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    GetChangedPluginSettings() : JsonPayload(Type) {}
+};
+
+// Announces plugin settings by their hash, the settings follow only if the server does not know the hash
+class PluginSettingsHash : public StringPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    PluginSettingsHash() : StringPayload(Type) {}
+
+    static String calculate(const MemoryBlock& block) {
+        return block.getSize() > 0 ? SHA256(block.getData(), block.getSize()).toHexString() : String();
+    }
+};
+
+// Plugin settings encoded as a binary delta to settings, that both sides know (see StateDelta)
+class PluginSettingsDelta : public BinaryPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    PluginSettingsDelta() : BinaryPayload(Type) {}
+};
+
+// Loads all plugins of a client with a single request, the server loads the plugins concurrently
+class LoadChain : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    LoadChain() : JsonPayload(Type) {}
+};
+
+// Presets and parameters or the error of a plugin loaded via LoadChain
+class LoadChainResult : public JsonPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    LoadChainResult() : JsonPayload(Type) {}
+};
+
+// Parameter values of a plugin: the plugin index (int) followed by a packed sequence of parameter index (int) and
+// value (float) pairs
+class ParameterValues : public BinaryPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    ParameterValues() : BinaryPayload(Type) {}
+};
+
+// Subscribes to the parameter changes of a plugin, the server pushes ParameterValues messages with the changed values
+// via the screen connection. A negative index cancels the subscription.
+class SubscribeParameters : public NumberPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    SubscribeParameters() : NumberPayload(Type) {}
+};
+
+// A batch of mouse events as a packed array of mouseevent_t
+class MouseEvents : public BinaryPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    MouseEvents() : BinaryPayload(Type) {}
+};
+
+struct paralleldry_t {
+    int group;
+    bool dry;
+};
+
+// Adds or removes an unprocessed (dry) branch to or from a parallel group
+class SetParallelDry : public DataPayload<paralleldry_t> {
+  public:
+    static constexpr int Type = __COUNTER__;
+    SetParallelDry() : DataPayload<paralleldry_t>(Type) {}
+};
+
+// The capabilities of the server (see Handshake::CAPABILITIES), sent as answer to a handshake of version 3 or newer
+class Capabilities : public NumberPayload {
+  public:
+    static constexpr int Type = __COUNTER__;
+    Capabilities() : NumberPayload(Type) {}
+};
+
 template <typename T>
 class Message : public LogTagDelegate {
   public:
@@ -40,6 +40,8 @@ void TimeStatistic::aggregate() {
         hist.avg = hist.sum / hist.count;
         auto nfIdx = (size_t)(hist.count * 0.95);
         hist.nintyFifth = data[nfIdx];
+        auto nnIdx = (size_t)(hist.count * 0.99);
+        hist.nintyNinth = data[nnIdx];
 
         // calc the distribution over m_numOfBins bins with a size of m_binSize seconds
         std::size_t count = 0;
@@ -86,6 +88,7 @@ TimeStatistic::Histogram TimeStatistic::get1minHistogram() {
             aggregate.sum += hist.sum;
             aggregate.count += hist.count;
             aggregate.nintyFifth += hist.nintyFifth;
+            aggregate.nintyNinth += hist.nintyNinth;
             for (std::size_t i = 0; i < m_numOfBins + 1; ++i) {
                 aggregate.updateBin(i, hist.dist[i].second);
             }
@@ -100,6 +103,7 @@ TimeStatistic::Histogram TimeStatistic::get1minHistogram() {
             aggregate.avg = aggregate.sum / aggregate.count;
         }
         aggregate.nintyFifth /= values.size();
+        aggregate.nintyNinth /= values.size();
     }
     return aggregate;
 }
@@ -109,8 +113,9 @@ void TimeStatistic::log(const String& name) {
         auto hist = get1minHistogram();
         if (hist.count > 0) {
             logln(name << ": total " << hist.count << ", rps " << String(m_meter.rate_1min(), 2) << ", 95th "
-                       << String(hist.nintyFifth) << "ms, avg " << String(hist.avg, 2) << "ms, min "
-                       << String(hist.min, 2) << "ms, max " << String(hist.max, 2) << "ms");
+                       << String(hist.nintyFifth) << "ms, 99th " << String(hist.nintyNinth) << "ms, avg "
+                       << String(hist.avg, 2) << "ms, min " << String(hist.min, 2) << "ms, max " << String(hist.max, 2)
+                       << "ms");
             String out = name;
             out << ":  dist ";
             size_t count = 0;
@@ -29,8 +29,12 @@ class Meter : public BasicStatistic {
     Meter() : ALPHA_1min(alpha(60)) {}
     ~Meter() override {}
 
-    inline void increment(uint32 i = 1) { m_counter += i; }
+    inline void increment(uint32 i = 1) {
+        m_counter += i;
+        m_total += i;
+    }
     inline double rate_1min() const { return m_rate_1min; }
+    inline uint64 total() const { return m_total; }
 
     void aggregate() override {}
     void aggregate1s() override {
@@ -41,12 +45,47 @@ class Meter : public BasicStatistic {
 
   private:
     std::atomic_uint_fast64_t m_counter{0};
+    std::atomic_uint_fast64_t m_total{0};
     double m_rate_1min = 0.0;
     const double ALPHA_1min;
 
     inline double alpha(int secs) { return 1 - std::exp(std::log(0.005) / secs); }
 };
 
+class Gauge : public BasicStatistic, public LogTag {
+  public:
+    Gauge() : LogTag("stats") {}
+    ~Gauge() override {}
+
+    inline void increment(int64 i = 1) { updateMax(m_value += i); }
+    inline void decrement(int64 i = 1) { m_value -= i; }
+    inline void set(int64 v) { updateMax(m_value = v); }
+    inline int64 get() const { return m_value; }
+    inline int64 getMax() const { return m_lastMax; }
+
+    void aggregate() override { m_lastMax = m_max.exchange(m_value); }
+    void aggregate1s() override {}
+    void log(const String& name) override {
+        if (m_showLog && m_lastMax > 0) {
+            logln(name << ": current " << m_value << ", max " << m_lastMax);
+        }
+    }
+
+    void setShowLog(bool b) { m_showLog = b; }
+
+  private:
+    bool m_showLog = true;
+    std::atomic<int64> m_value{0};
+    std::atomic<int64> m_max{0};
+    std::atomic<int64> m_lastMax{0};
+
+    inline void updateMax(int64 v) {
+        auto m = m_max.load();
+        while (v > m && !m_max.compare_exchange_weak(m, v)) {
+        }
+    }
+};
+
 class TimeStatistic : public BasicStatistic, public LogTag {
   public:
     class Duration {
@@ -113,6 +152,7 @@ class TimeStatistic : public BasicStatistic, public LogTag {
         double avg = 0;
         double sum = 0;
         double nintyFifth = 0;
+        double nintyNinth = 0;
         size_t count = 0;
         std::vector<std::pair<double, size_t>> dist;
 
@@ -172,13 +212,14 @@ class Metrics : public Thread, public LogTag, public SharedInstance<Metrics> {
 
     static StatsMap getStats();
 
-    template <typename T>
-    static std::shared_ptr<T> getStatistic(const String& name) {
+    // Additional arguments are passed to the constructor, if the statistic does not exist yet
+    template <typename T, typename... Args>
+    static std::shared_ptr<T> getStatistic(const String& name, Args&&... args) {
         std::lock_guard<std::mutex> lock(m_statsMtx);
         std::shared_ptr<T> stat;
         auto it = m_stats.find(name);
         if (m_stats.end() == it) {
-            auto itnew = m_stats.emplace(name, std::make_shared<T>());
+            auto itnew = m_stats.emplace(name, std::make_shared<T>(std::forward<Args>(args)...));
             stat = std::dynamic_pointer_cast<T>(itnew.first->second);
         } else {
             stat = std::dynamic_pointer_cast<T>(it->second);
@@ -186,6 +227,11 @@ class Metrics : public Thread, public LogTag, public SharedInstance<Metrics> {
         return stat;
     }
 
+    static void removeStatistic(const String& name) {
+        std::lock_guard<std::mutex> lock(m_statsMtx);
+        m_stats.erase(name);
+    }
+
   private:
     static StatsMap m_stats;
     static std::mutex m_statsMtx;
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef StateDelta_hpp
+#define StateDelta_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+namespace e47 {
+
+/*
+ * Binary delta encoding for plugin states in the style of rsync. The blocks of the basis are indexed by a rolling
+ * checksum, that is moved over the target byte by byte. Matching ranges are encoded as a reference into the basis,
+ * everything else is sent as literal data. A delta against an empty basis contains the full target.
+ */
+namespace StateDelta {
+
+static constexpr size_t BLOCK_SIZE = 256;
+
+enum OpCode : uint8 { OP_COPY = 1, OP_DATA = 2 };
+
+struct Checksum {
+    uint32 a = 0, b = 0;
+
+    void init(const uint8* p, size_t len) {
+        a = b = 0;
+        for (size_t i = 0; i < len; i++) {
+            a += p[i];
+            b += (uint32)(len - i) * p[i];
+        }
+    }
+
+    void roll(uint8 out, uint8 in, size_t len) {
+        a += (uint32)in - out;
+        b += a - (uint32)len * out;
+    }
+
+    uint32 get() const { return (b << 16) | (a & 0xffff); }
+};
+
+inline void writeData(MemoryOutputStream& out, const uint8* p, size_t len) {
+    if (len > 0) {
+        out.writeByte((char)OP_DATA);
+        out.writeInt((int)len);
+        out.write(p, len);
+    }
+}
+
+inline MemoryBlock create(const MemoryBlock& basis, const MemoryBlock& target) {
+    MemoryOutputStream out;
+    auto* src = static_cast<const uint8*>(basis.getData());
+    auto* dst = static_cast<const uint8*>(target.getData());
+    size_t srcLen = basis.getSize();
+    size_t dstLen = target.getSize();
+    if (srcLen < BLOCK_SIZE || dstLen < BLOCK_SIZE) {
+        writeData(out, dst, dstLen);
+        return out.getMemoryBlock();
+    }
+    std::unordered_multimap<uint32, size_t> blocks;
+    blocks.reserve(srcLen / BLOCK_SIZE);
+    Checksum sum;
+    for (size_t off = 0; off + BLOCK_SIZE <= srcLen; off += BLOCK_SIZE) {
+        sum.init(src + off, BLOCK_SIZE);
+        blocks.emplace(sum.get(), off);
+    }
+    size_t pos = 0, literal = 0;
+    sum.init(dst, BLOCK_SIZE);
+    while (pos + BLOCK_SIZE <= dstLen) {
+        bool matched = false;
+        auto range = blocks.equal_range(sum.get());
+        for (auto it = range.first; it != range.second; ++it) {
+            auto off = it->second;
+            if (memcmp(src + off, dst + pos, BLOCK_SIZE) == 0) {
+                // extend the match as far as possible
+                size_t len = BLOCK_SIZE;
+                while (off + len < srcLen && pos + len < dstLen && src[off + len] == dst[pos + len]) {
+                    len++;
+                }
+                writeData(out, dst + literal, pos - literal);
+                out.writeByte((char)OP_COPY);
+                out.writeInt((int)off);
+                out.writeInt((int)len);
+                pos += len;
+                literal = pos;
+                if (pos + BLOCK_SIZE <= dstLen) {
+                    sum.init(dst + pos, BLOCK_SIZE);
+                }
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            if (pos + BLOCK_SIZE < dstLen) {
+                sum.roll(dst[pos], dst[pos + BLOCK_SIZE], BLOCK_SIZE);
+            }
+            pos++;
+        }
+    }
+    writeData(out, dst + literal, dstLen - literal);
+    return out.getMemoryBlock();
+}
+
+inline bool apply(const MemoryBlock& basis, const MemoryBlock& delta, MemoryBlock& target) {
+    MemoryInputStream in(delta, false);
+    auto* data = static_cast<const uint8*>(delta.getData());
+    target.reset();
+    while (!in.isExhausted()) {
+        auto op = (uint8)in.readByte();
+        if (op == OP_COPY) {
+            auto off = (size_t)(uint32)in.readInt();
+            auto len = (size_t)(uint32)in.readInt();
+            if (off + len > basis.getSize()) {
+                return false;
+            }
+            target.append(static_cast<const uint8*>(basis.getData()) + off, len);
+        } else if (op == OP_DATA) {
+            auto len = (size_t)(uint32)in.readInt();
+            auto pos = (size_t)in.getPosition();
+            if (pos + len > delta.getSize()) {
+                return false;
+            }
+            target.append(data + pos, len);
+            in.skipNextBytes((int64)len);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace StateDelta
+
+}  // namespace e47
+
+#endif /* StateDelta_hpp */
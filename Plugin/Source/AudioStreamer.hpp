@@ -34,6 +34,15 @@ class AudioStreamer : public Thread, public LogTagDelegate {
             buf.audio.clear();
             m_readQ.push(std::move(buf));
         }
+        int frameRest = clnt->getSamplesPerBlock() - clnt->getHostBlockSize();
+        if (clnt->NUM_OF_BUFFERS > 0 && frameRest > 0) {
+            // when aggregating host blocks, the first frame is sent after frameRest samples, so we need to hand out
+            // frameRest samples more to give each frame a full frame of time for the round trip
+            AudioMidiBuffer buf;
+            buf.audio.setSize(jmax(clnt->getChannelsIn(), clnt->getChannelsOut()), frameRest);
+            buf.audio.clear();
+            m_readQ.push(std::move(buf));
+        }
         m_workingSendBuf.audio.clear();
         m_workingReadBufe.audio.clear();
 
@@ -110,6 +119,10 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                 m_writeQ.push(std::move(buf));
                 notifyWrite();
             } else {
+                if (m_workingSendSamples == 0) {
+                    // a frame starts at the position of its first block
+                    m_workingSendPosInfo = posInfo;
+                }
                 if (!copyToWorkingBuffer(m_workingSendBuf, m_workingSendSamples, buffer, midi,
                                          m_client->getChannelsIn() == 0)) {
                     logln("error: " << getInstanceString() << ": send error");
@@ -130,12 +143,13 @@ class AudioStreamer : public Thread, public LogTagDelegate {
                     }
                     buf.midi.addEvents(m_workingSendBuf.midi, 0, m_client->getSamplesPerBlock(), 0);
                     m_workingSendBuf.midi.clear(0, m_client->getSamplesPerBlock());
-                    buf.posInfo = posInfo;
+                    buf.posInfo = m_workingSendPosInfo;
                     m_writeQ.push(std::move(buf));
                     notifyWrite();
                     m_workingSendSamples -= m_client->getSamplesPerBlock();
                     if (m_workingSendSamples > 0) {
                         shiftSamplesToFront(m_workingSendBuf, m_client->getSamplesPerBlock(), m_workingSendSamples);
+                        m_workingSendPosInfo = posInfo;
                     }
                 }
             }
@@ -234,6 +248,7 @@ class AudioStreamer : public Thread, public LogTagDelegate {
     AudioMidiBuffer m_workingSendBuf, m_workingReadBufe;
     int m_workingSendSamples = 0;
     int m_workingReadSamples = 0;
+    AudioPlayHead::CurrentPositionInfo m_workingSendPosInfo;
 
     std::atomic_bool m_error{false};
 
@@ -339,14 +354,15 @@ class AudioStreamer : public Thread, public LogTagDelegate {
 
     bool sendReal(AudioMidiBuffer& buffer) {
         traceScope();
-        AudioMessage msg(m_client);
+        AudioMessage msg(m_client, m_client->hasCapability(Handshake::CAP_SILENT_CHANNELS));
+        auto threshold = (T)Decibels::decibelsToGain(m_client->SILENCE_THRESHOLD_DB.load(), -1000.0f);
         return msg.sendToServer(m_socket.get(), buffer.audio, buffer.midi, buffer.posInfo, buffer.channelsRequested,
-                                buffer.samplesRequested, nullptr, *m_bytesOutMeter);
+                                buffer.samplesRequested, threshold, nullptr, *m_bytesOutMeter);
     }
 
     bool readReal(AudioMidiBuffer& buffer, MessageHelper::Error* e) {
         traceScope();
-        AudioMessage msg(m_client);
+        AudioMessage msg(m_client, m_client->hasCapability(Handshake::CAP_SILENT_CHANNELS));
         if (buffer.audio.getNumChannels() < buffer.channelsRequested ||
             buffer.audio.getNumSamples() < buffer.samplesRequested) {
             buffer.audio.setSize(buffer.channelsRequested, buffer.samplesRequested);
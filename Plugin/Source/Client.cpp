@@ -11,6 +11,9 @@
 #include "NumberConversion.hpp"
 #include "ServiceReceiver.hpp"
 #include "AudioStreamer.hpp"
+#include "StateDelta.hpp"
+#include "ParameterCache.hpp"
+#include "ConfigWatcher.hpp"
 
 #ifdef JUCE_WINDOWS
 #include "windows.h"
@@ -31,6 +34,7 @@ Client::Client(AudioGridderAudioProcessor* processor)
 Client::~Client() {
     traceScope();
     signalThreadShouldExit();
+    m_inputSender.reset();
     close();
     count--;
 }
@@ -38,26 +42,41 @@ Client::~Client() {
 void Client::run() {
     traceScope();
     logln("entering client loop");
+    // input events need a connection, so the sender thread is created here instead of with every instance
+    if (nullptr == m_inputSender) {
+        m_inputSender = std::make_unique<InputSender>(this);
+    }
     uint32 cpuUpdateSeconds = 5;
     uint32 syncSeconds = 10;
     uint32 loops = 0;
+    uint64 cfgVersion = 0;
     bool lastState = isReady();
     while (!currentThreadShouldExit()) {
-        // Check for config updates from other clients
-        auto cfg = configParseFile(Defaults::getConfigFileName(Defaults::ConfigPlugin));
-        int newNum;
-        newNum = jsonGetValue(cfg, "NumberOfBuffers", NUM_OF_BUFFERS.load());
-        if (NUM_OF_BUFFERS != newNum) {
-            logln("number of buffers changed from " << NUM_OF_BUFFERS << " to " << newNum);
-            NUM_OF_BUFFERS = newNum;
-            reconnect();
-        }
-        newNum = jsonGetValue(cfg, "LoadPluginTimeoutMS", LOAD_PLUGIN_TIMEOUT.load());
-        if (LOAD_PLUGIN_TIMEOUT != newNum) {
-            logln("timeout for leading a plugin changed from " << LOAD_PLUGIN_TIMEOUT << " to " << newNum);
-            LOAD_PLUGIN_TIMEOUT = newNum;
-        }
-        m_processor->loadConfig(cfg, true);
+        // Check for config updates from other clients, the file is watched for all instances of the process
+        auto watcher = ConfigWatcher::getInstance();
+        auto cfgSnapshot = nullptr != watcher ? watcher->getConfig(cfgVersion) : nullptr;
+        if (nullptr != cfgSnapshot) {
+            auto& cfg = *cfgSnapshot;
+            int newNum;
+            newNum = jsonGetValue(cfg, "NumberOfBuffers", NUM_OF_BUFFERS.load());
+            if (NUM_OF_BUFFERS != newNum) {
+                logln("number of buffers changed from " << NUM_OF_BUFFERS << " to " << newNum);
+                NUM_OF_BUFFERS = newNum;
+                reconnect();
+            }
+            newNum = jsonGetValue(cfg, "NetworkFrameSize", NETWORK_FRAME_SIZE.load());
+            if (NETWORK_FRAME_SIZE != newNum) {
+                logln("network frame size changed from " << NETWORK_FRAME_SIZE << " to " << newNum);
+                NETWORK_FRAME_SIZE = newNum;
+                reconnect();
+            }
+            newNum = jsonGetValue(cfg, "LoadPluginTimeoutMS", LOAD_PLUGIN_TIMEOUT.load());
+            if (LOAD_PLUGIN_TIMEOUT != newNum) {
+                logln("timeout for leading a plugin changed from " << LOAD_PLUGIN_TIMEOUT << " to " << newNum);
+                LOAD_PLUGIN_TIMEOUT = newNum;
+            }
+            m_processor->loadConfig(cfg, true);
+        }
 
         // Try to auto connect to the first available host discovered via mDNS
         if (m_srvHost.isEmpty()) {
@@ -89,6 +108,8 @@ void Client::run() {
         // CPU load update
         if ((loops % cpuUpdateSeconds == 0) && isReadyLockFree()) {
             updateCPULoad();
+            updatePluginStats();
+            updateOverloadEvents();
         }
 
         // Trigger sync
@@ -167,11 +188,11 @@ void Client::init(int channelsIn, int channelsOut, double rate, int samplesPerBl
                               << samplesPerBlock << " doublePrecission=" << as<int>(doublePrecission));
     LockByID lock(*this, INIT1);
     if (!m_ready || m_channelsIn != channelsIn || m_channelsOut != channelsOut || m_rate != rate ||
-        m_samplesPerBlock != samplesPerBlock || m_doublePrecission != doublePrecission) {
+        m_hostBlockSize != samplesPerBlock || m_doublePrecission != doublePrecission) {
         m_channelsIn = channelsIn;
         m_channelsOut = channelsOut;
         m_rate = rate;
-        m_samplesPerBlock = samplesPerBlock;
+        m_hostBlockSize = samplesPerBlock;
         m_doublePrecission = doublePrecission;
         m_needsReconnect = true;
         m_ready = false;
@@ -192,9 +213,19 @@ void Client::init() {
     }
     LockByID lock(*this, INIT2);
     m_error = true;
-    if (m_channelsOut == 0 || m_rate == 0.0 || m_samplesPerBlock == 0) {
+    if (m_channelsOut == 0 || m_rate == 0.0 || m_hostBlockSize == 0) {
         return;
     }
+    // Aggregate host blocks into frames of at least NETWORK_FRAME_SIZE samples. This requires buffering, so it is
+    // only done if buffering is enabled.
+    int frameSize = m_hostBlockSize;
+    if (NUM_OF_BUFFERS > 0 && NETWORK_FRAME_SIZE > m_hostBlockSize) {
+        frameSize = (NETWORK_FRAME_SIZE + m_hostBlockSize - 1) / m_hostBlockSize * m_hostBlockSize;
+    }
+    if (frameSize != m_samplesPerBlock) {
+        logln("network frame size: " << frameSize << " samples (" << frameSize / m_hostBlockSize << " host block(s))");
+        m_samplesPerBlock = frameSize;
+    }
     logln("connecting server " << host << ":" << id);
     m_cmd_socket = std::make_unique<StreamingSocket>();
     if (m_cmd_socket->connect(host, port, 1000)) {
@@ -238,8 +269,9 @@ void Client::init() {
             logln("failed to set master socket non-blocking");
         }
 
-        Handshake cfg = {2,      clientPort,        m_channelsIn,       m_channelsOut,
-                         m_rate, m_samplesPerBlock, m_doublePrecission, getId()};
+        Handshake cfg = {Handshake::VERSION, clientPort,        m_channelsIn,       m_channelsOut,
+                         m_rate,             m_samplesPerBlock, m_doublePrecission, getId()};
+        cfg.capabilities = Handshake::CAP_ALL;
         if (m_processor->getNoSrvPluginListFilter()) {
             cfg.setFlag(Handshake::NO_PLUGINLIST_FILTER);
         }
@@ -249,17 +281,9 @@ void Client::init() {
             return;
         }
 
-        auto* audioSock = accept(sock);
+        auto audioSock = std::unique_ptr<StreamingSocket>(accept(sock));
         if (nullptr != audioSock) {
             logln("audio connection established");
-            std::lock_guard<std::mutex> audiolck(m_audioMtx);
-            if (m_doublePrecission) {
-                m_audioStreamerD = std::make_shared<AudioStreamer<double>>(this, audioSock);
-                m_audioStreamerD->startThread(Thread::realtimeAudioPriority);
-            } else {
-                m_audioStreamerF = std::make_shared<AudioStreamer<float>>(this, audioSock);
-                m_audioStreamerF->startThread(Thread::realtimeAudioPriority);
-            }
         } else {
             return;
         }
@@ -273,8 +297,20 @@ void Client::init() {
             return;
         }
 
-        // receive plugin list
-        updatePluginList();
+        // receive the server capabilities and the plugin list
+        readServerCapabilities();
+
+        // the audio header layout depends on the server capabilities
+        {
+            std::lock_guard<std::mutex> audiolck(m_audioMtx);
+            if (m_doublePrecission) {
+                m_audioStreamerD = std::make_shared<AudioStreamer<double>>(this, audioSock.release());
+                m_audioStreamerD->startThread(Thread::realtimeAudioPriority);
+            } else {
+                m_audioStreamerF = std::make_shared<AudioStreamer<float>>(this, audioSock.release());
+                m_audioStreamerF->startThread(Thread::realtimeAudioPriority);
+            }
+        }
 
         m_ready = true;
         m_error = false;
@@ -368,14 +404,21 @@ void Client::quit() {
     msg.send(m_cmd_socket.get());
 }
 
-bool Client::addPlugin(String id, StringArray& presets, Array<Parameter>& params, String settings, String& err) {
+bool Client::addPlugin(String id, StringArray& presets, Array<Parameter>& params, const MemoryBlock& settings,
+                       String& err) {
     traceScope();
     if (!isReadyLockFree()) {
         return false;
     };
     MessageHelper::Error e;
     Message<AddPlugin> msg(this);
-    PLD(msg).setString(id);
+    if (hasCapability(Handshake::CAP_PARAMETER_CACHE)) {
+        json j = {{"id", id.toStdString()}, {"paramsVersion", ParameterCache::getVersion(id).toStdString()}};
+        PLD(msg).setJson(j);
+    } else {
+        // old servers expect the plain id
+        PLD(msg).setData(id.toRawUTF8(), (int)id.getNumBytesAsUTF8());
+    }
     LockByID lock(*this, ADDPLUGIN);
     TimeStatistic::Timeout timeout(LOAD_PLUGIN_TIMEOUT);
     if (msg.send(m_cmd_socket.get())) {
@@ -415,25 +458,17 @@ bool Client::addPlugin(String id, StringArray& presets, Array<Parameter>& params
             return false;
         }
         auto jparams = msgParams.payload.getJson();
-        Array<Parameter> paramsBak(std::move(params));
-        for (auto& jparam : jparams) {
-            auto newParam = Parameter::fromJson(jparam);
-            for (auto& oldParam : paramsBak) {
-                if (newParam.idx == oldParam.idx) {
-                    newParam.automationSlot = oldParam.automationSlot;
-                    break;
-                }
-            }
-            params.add(std::move(newParam));
+        if (!hasCapability(Handshake::CAP_PARAMETER_CACHE)) {
+            // old servers send the plain metadata array
+            jparams = {{"parameters", jparams}};
         }
-        Message<PluginSettings> msgSettings(this);
-        if (settings.isNotEmpty()) {
-            MemoryBlock block;
-            block.fromBase64Encoding(settings);
-            msgSettings.payload.setData(block.begin(), static_cast<int>(block.getSize()));
+        // the settings have to follow in any case to keep the protocol in sync
+        bool paramsOk = updateParameters(id, params, jparams);
+        if (!sendPluginSettings(settings, err)) {
+            logln(err);
+            return false;
         }
-        if (!msgSettings.send(m_cmd_socket.get())) {
-            err = "failed to send settings";
+        if (!paramsOk && !requestParameters(jsonGetValue(jparams, "idx", -1), id, params, err)) {
             logln(err);
             return false;
         }
@@ -443,6 +478,180 @@ bool Client::addPlugin(String id, StringArray& presets, Array<Parameter>& params
     return false;
 }
 
+bool Client::loadChain(std::vector<ChainPlugin>& plugins, String& err) {
+    traceScope();
+    if (!isReadyLockFree()) {
+        return false;
+    };
+    if (!hasCapability(Handshake::CAP_LOAD_CHAIN)) {
+        // old servers load one plugin per request
+        for (auto& p : plugins) {
+            p.ok = addPlugin(p.id, *p.presets, *p.params, *p.settings, p.error);
+        }
+        return true;
+    }
+    json jplugins = json::array();
+    for (auto& p : plugins) {
+        jplugins.push_back({{"id", p.id.toStdString()},
+                            {"hash", PluginSettingsHash::calculate(*p.settings).toStdString()},
+                            {"paramsVersion", ParameterCache::getVersion(p.id).toStdString()}});
+    }
+    json j = {{"plugins", jplugins}};
+    Message<LoadChain> msg(this);
+    PLD(msg).setJson(j);
+    MessageHelper::Error e;
+    LockByID lock(*this, LOADCHAIN);
+    // the server loads the plugins concurrently, but some might have to wait for others
+    TimeStatistic::Timeout timeout(LOAD_PLUGIN_TIMEOUT * jmax(1, (int)plugins.size()));
+    if (!msg.send(m_cmd_socket.get())) {
+        err = "failed to send LoadChain message";
+        logln(err);
+        return false;
+    }
+    if (!msg.read(m_cmd_socket.get(), &e, timeout.getMillisecondsLeft())) {
+        err = "failed to read LoadChain message: " + e.toString();
+        logln(err);
+        return false;
+    }
+    auto reply = PLD(msg).getJson();
+    if (reply.find("error") != reply.end()) {
+        err = reply["error"].get<std::string>();
+        logln(err);
+        return false;
+    }
+    // send the settings, that the server does not know
+    for (auto& jidx : reply["missing"]) {
+        auto idx = jidx.get<size_t>();
+        if (idx >= plugins.size()) {
+            err = "invalid LoadChain reply";
+            logln(err);
+            return false;
+        }
+        auto delta = StateDelta::create({}, *plugins[idx].settings);
+        Message<PluginSettingsDelta> msgDelta(this);
+        msgDelta.payload.setData(delta.begin(), static_cast<int>(delta.getSize()));
+        if (!msgDelta.send(m_cmd_socket.get())) {
+            err = "failed to send settings";
+            logln(err);
+            return false;
+        }
+    }
+    // the server sends the results in the order the plugins finish loading
+    std::vector<bool> received(plugins.size(), false);
+    std::vector<size_t> missingParams;
+    for (size_t n = 0; n < plugins.size(); n++) {
+        Message<LoadChainResult> msgRes(this);
+        if (timeout.getMillisecondsLeft() == 0 || !msgRes.read(m_cmd_socket.get(), &e, timeout.getMillisecondsLeft())) {
+            err = "failed to read LoadChainResult message: " + e.toString();
+            logln(err);
+            return false;
+        }
+        auto jres = msgRes.payload.getJson();
+        auto idx = jsonGetValue(jres, "idx", -1);
+        if (idx < 0 || (size_t)idx >= plugins.size() || received[(size_t)idx]) {
+            err = "invalid LoadChainResult";
+            logln(err);
+            return false;
+        }
+        received[(size_t)idx] = true;
+        auto& p = plugins[(size_t)idx];
+        if (jres.find("error") != jres.end()) {
+            p.ok = false;
+            p.error = jres["error"].get<std::string>();
+            continue;
+        }
+        *p.presets = StringArray::fromTokens(jsonGetValue(jres, "presets", String()), "|", "");
+        if (!updateParameters(p.id, *p.params, jres["parameters"])) {
+            missingParams.push_back((size_t)idx);
+        }
+        p.ok = true;
+    }
+    auto result = m_msgFactory.getResult(m_cmd_socket.get(), 5, &e);
+    if (nullptr == result) {
+        err = "failed to get result: " + e.toString();
+        logln(err);
+        return false;
+    }
+    m_latency = result->getReturnCode();
+    // the metadata of plugins, that missed the parameter cache, can be requested now, that the chain is complete
+    for (auto i : missingParams) {
+        // the server chain has the loaded plugins only
+        int serverIdx = 0;
+        for (size_t k = 0; k < i; k++) {
+            if (plugins[k].ok) {
+                serverIdx++;
+            }
+        }
+        auto& p = plugins[i];
+        if (!requestParameters(serverIdx, p.id, *p.params, err)) {
+            logln(err);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Client::updateParameters(const String& id, Array<Parameter>& params, const json& j) {
+    traceScope();
+    auto version = jsonGetValue(j, "version", String());
+    json jparams;
+    if (jsonHasValue(j, "parameters")) {
+        jparams = j["parameters"];
+        if (version.isNotEmpty()) {
+            ParameterCache::put(id, version, jparams);
+        }
+    } else if (ParameterCache::get(id, version, jparams)) {
+        // the server sent the current values only
+        auto& jvalues = j["values"];
+        for (size_t i = 0; i < jparams.size() && i < jvalues.size(); i++) {
+            jparams[i]["currentValue"] = jvalues[i];
+        }
+    } else {
+        logln("parameter metadata version " << version << " for " << id << " not found in cache");
+        return false;
+    }
+    Array<Parameter> paramsBak(std::move(params));
+    for (auto& jparam : jparams) {
+        auto newParam = Parameter::fromJson(jparam);
+        for (auto& oldParam : paramsBak) {
+            if (newParam.idx == oldParam.idx) {
+                newParam.automationSlot = oldParam.automationSlot;
+                break;
+            }
+        }
+        params.add(std::move(newParam));
+    }
+    return true;
+}
+
+bool Client::requestParameters(int idx, const String& id, Array<Parameter>& params, String& err) {
+    traceScope();
+    logln("parameter metadata for " << id << " not cached, requesting it");
+    // an empty version makes the server send the full metadata
+    json j = {{"idx", idx}, {"paramsVersion", ""}};
+    Message<Parameters> msg(this);
+    PLD(msg).setJson(j);
+    MessageHelper::Error e;
+    if (!msg.send(m_cmd_socket.get())) {
+        err = "failed to send Parameters message";
+        return false;
+    }
+    if (!msg.read(m_cmd_socket.get(), &e, LOAD_PLUGIN_TIMEOUT)) {
+        err = "failed to read parameters: " + e.toString();
+        return false;
+    }
+    auto jparams = PLD(msg).getJson();
+    if (jsonHasValue(jparams, "error")) {
+        err = "failed to read parameters: " + jsonGetValue(jparams, "error", String());
+        return false;
+    }
+    if (!updateParameters(id, params, jparams)) {
+        err = "failed to read parameters: no metadata";
+        return false;
+    }
+    return true;
+}
+
 void Client::delPlugin(int idx) {
     traceScope();
     if (!isReadyLockFree()) {
@@ -479,17 +688,44 @@ void Client::hidePlugin() {
     msg.send(m_cmd_socket.get());
 }
 
-MemoryBlock Client::getPluginSettings(int idx) {
+MemoryBlock Client::getPluginSettings(int idx, const String& knownHash, const MemoryBlock& knownSettings) {
     traceScope();
     MemoryBlock block;
     if (!isReadyLockFree()) {
         return block;
     };
-    Message<GetPluginSettings> msg(this);
-    PLD(msg).setNumber(idx);
+    bool sent;
+    // old servers always send the full settings
+    bool delta = knownHash.isNotEmpty() && hasCapability(Handshake::CAP_SETTINGS_HASH);
     LockByID lock(*this, GETPLUGINSETTINGS);
-    if (!msg.send(m_cmd_socket.get())) {
+    if (delta) {
+        Message<GetChangedPluginSettings> msg(this);
+        json j = {{"idx", idx}, {"hash", knownHash.toStdString()}};
+        PLD(msg).setJson(j);
+        sent = msg.send(m_cmd_socket.get());
+    } else {
+        Message<GetPluginSettings> msg(this);
+        PLD(msg).setNumber(idx);
+        sent = msg.send(m_cmd_socket.get());
+    }
+    if (!sent) {
         m_error = true;
+    } else if (delta) {
+        Message<PluginSettingsDelta> res(this);
+        MessageHelper::Error err;
+        if (res.read(m_cmd_socket.get(), &err, 5000)) {
+            if (*res.payload.size > 0) {
+                MemoryBlock delta;
+                delta.append(res.payload.data, as<size_t>(*res.payload.size));
+                if (!StateDelta::apply(knownSettings, delta, block)) {
+                    logln(getLoadedPluginsString() << ": failed to apply plugin settings delta");
+                    block.reset();
+                }
+            }
+        } else {
+            logln(getLoadedPluginsString() << ": failed to read PluginSettingsDelta message: " << err.toString());
+            m_error = true;
+        }
     } else {
         Message<PluginSettings> res(this);
         MessageHelper::Error err;
@@ -505,7 +741,8 @@ MemoryBlock Client::getPluginSettings(int idx) {
     return block;
 }
 
-void Client::setPluginSettings(int idx, String settings) {
+void Client::setPluginSettings(int idx, const MemoryBlock& settings, const String& knownHash,
+                               const MemoryBlock& knownSettings) {
     traceScope();
     Message<SetPluginSettings> msg(this);
     PLD(msg).setNumber(idx);
@@ -513,17 +750,56 @@ void Client::setPluginSettings(int idx, String settings) {
     if (!msg.send(m_cmd_socket.get())) {
         m_error = true;
     } else {
-        Message<PluginSettings> msgSettings(this);
-        if (settings.isNotEmpty()) {
-            MemoryBlock block;
-            block.fromBase64Encoding(settings);
-            msgSettings.payload.setData(block.begin(), static_cast<int>(block.getSize()));
+        String err;
+        if (!sendPluginSettings(settings, err, knownHash, knownSettings)) {
+            logln(err);
+            m_error = true;
         }
+    }
+}
+
+bool Client::sendPluginSettings(const MemoryBlock& settings, String& err, const String& knownHash,
+                                const MemoryBlock& knownSettings) {
+    traceScope();
+    if (!hasCapability(Handshake::CAP_SETTINGS_HASH)) {
+        Message<PluginSettings> msgSettings(this);
+        msgSettings.payload.setData(settings.begin(), static_cast<int>(settings.getSize()));
         if (!msgSettings.send(m_cmd_socket.get())) {
-            logln("failed to send settings");
-            m_error = true;
+            err = "failed to send settings";
+            return false;
         }
+        return true;
+    }
+    Message<PluginSettingsHash> msgHash(this);
+    msgHash.payload.setString(PluginSettingsHash::calculate(settings));
+    if (!msgHash.send(m_cmd_socket.get())) {
+        err = "failed to send settings hash";
+        return false;
+    }
+    if (settings.getSize() == 0) {
+        return true;
     }
+    MessageHelper::Error e;
+    auto result = m_msgFactory.getResult(m_cmd_socket.get(), 5, &e);
+    if (nullptr == result) {
+        err = "failed to get settings hash result: " + e.toString();
+        return false;
+    }
+    if (result->getReturnCode() == 1) {
+        // the server knows the settings already
+        return true;
+    }
+    // the server offers its current settings as basis for a delta
+    auto delta = knownHash.isNotEmpty() && knownHash == result->getString()
+                     ? StateDelta::create(knownSettings, settings)
+                     : StateDelta::create({}, settings);
+    Message<PluginSettingsDelta> msgDelta(this);
+    msgDelta.payload.setData(delta.begin(), static_cast<int>(delta.getSize()));
+    if (!msgDelta.send(m_cmd_socket.get())) {
+        err = "failed to send settings";
+        return false;
+    }
+    return true;
 }
 
 void Client::bypassPlugin(int idx) {
@@ -560,6 +836,63 @@ void Client::exchangePlugins(int idxA, int idxB) {
     msg.send(m_cmd_socket.get());
 }
 
+void Client::setParallelBranch(int idx, int group, int branch) {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_PARALLEL)) {
+        return;
+    };
+    Message<SetParallelBranch> msg(this);
+    DATA(msg)->idx = idx;
+    DATA(msg)->group = group;
+    DATA(msg)->branch = branch;
+    LockByID lock(*this, SETPARALLELBRANCH);
+    msg.send(m_cmd_socket.get());
+    auto result = m_msgFactory.getResult(m_cmd_socket.get());
+    if (nullptr != result && result->getReturnCode() > -1) {
+        m_latency = result->getReturnCode();
+    }
+}
+
+void Client::setParallelDry(int group, bool dry) {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_PARALLEL)) {
+        return;
+    };
+    Message<SetParallelDry> msg(this);
+    DATA(msg)->group = group;
+    DATA(msg)->dry = dry;
+    LockByID lock(*this, SETPARALLELDRY);
+    msg.send(m_cmd_socket.get());
+    auto result = m_msgFactory.getResult(m_cmd_socket.get());
+    if (nullptr != result && result->getReturnCode() > -1) {
+        m_latency = result->getReturnCode();
+    }
+}
+
+void Client::setBus(const String& sendBus, const String& returnBus) {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_BUSES)) {
+        return;
+    };
+    Message<SetBus> msg(this);
+    json j = {{"send", sendBus.toStdString()}, {"return", returnBus.toStdString()}};
+    PLD(msg).setJson(j);
+    LockByID lock(*this, SETBUS);
+    msg.send(m_cmd_socket.get());
+}
+
+void Client::setSidechain(const String& publish, bool publishOutput, const String& source) {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_BUSES)) {
+        return;
+    };
+    Message<SetSidechain> msg(this);
+    json j = {{"publish", publish.toStdString()}, {"publishOutput", publishOutput}, {"source", source.toStdString()}};
+    PLD(msg).setJson(j);
+    LockByID lock(*this, SETSIDECHAIN);
+    msg.send(m_cmd_socket.get());
+}
+
 std::vector<ServerPlugin> Client::getRecents() {
     traceScope();
     std::vector<ServerPlugin> recents;
@@ -642,35 +975,91 @@ Array<Client::ParameterResult> Client::getAllParameterValues(int idx, int cnt) {
     PLD(msg).setNumber(idx);
     LockByID lock(*this, GETALLPARAMETERVALUES);
     msg.send(m_cmd_socket.get());
-    Array<Client::ParameterResult> ret;
-    for (int i = 0; i < cnt; i++) {
-        Message<ParameterValue> msgVal(this);
-        MessageHelper::Error err;
-        if (msgVal.read(m_cmd_socket.get(), &err)) {
-            if (idx == DATA(msgVal)->idx) {
+    MessageHelper::Error err;
+    if (!hasCapability(Handshake::CAP_PARAMETER_VALUES)) {
+        // old servers send a message per parameter
+        Array<ParameterResult> ret;
+        for (int i = 0; i < cnt; i++) {
+            Message<ParameterValue> msgVal(this);
+            if (msgVal.read(m_cmd_socket.get(), &err) && idx == DATA(msgVal)->idx) {
                 ret.add({DATA(msgVal)->paramIdx, DATA(msgVal)->value});
             }
         }
+        return ret;
+    }
+    Message<ParameterValues> msgVals(this);
+    if (!msgVals.read(m_cmd_socket.get(), &err)) {
+        logln("failed to read parameter values: " << err.toString());
+        return {};
+    }
+    int retIdx;
+    auto ret = readParameterValues(msgVals, retIdx);
+    if (retIdx != idx) {
+        logln("error: plugin index mismatch in getAllParameterValues");
+        return {};
+    }
+    if (ret.size() != cnt) {
+        logln("received " << ret.size() << " parameter values, expected " << cnt);
     }
     return ret;
 }
 
+Array<Client::ParameterResult> Client::readParameterValues(Message<ParameterValues>& msg, int& idx) {
+    Array<ParameterResult> ret;
+    idx = -1;
+    if (*msg.payload.size >= (int)sizeof(int)) {
+        MemoryInputStream in(msg.payload.data, as<size_t>(*msg.payload.size), false);
+        idx = in.readInt();
+        ret.ensureStorageAllocated((int)(in.getNumBytesRemaining() / (sizeof(int) + sizeof(float))));
+        while (in.getNumBytesRemaining() >= (int64)(sizeof(int) + sizeof(float))) {
+            auto paramIdx = in.readInt();
+            auto value = in.readFloat();
+            ret.add({paramIdx, value});
+        }
+    }
+    return ret;
+}
+
+void Client::subscribeParameters(int idx) {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_PARAMETER_VALUES)) {
+        return;
+    };
+    Message<SubscribeParameters> msg(this);
+    PLD(msg).setNumber(idx);
+    LockByID lock(*this, SUBSCRIBEPARAMETERS);
+    msg.send(m_cmd_socket.get());
+}
+
 void Client::ScreenReceiver::run() {
     traceScope();
-    Message<ScreenCapture> msg(getLogTagSource());
     MessageHelper::Error err;
     do {
-        if (msg.read(m_socket, &err, 200)) {
-            if (PLD(msg).hdr->size > 0) {
-                int width = (int)(PLD(msg).hdr->width / PLD(msg).hdr->scale);
-                int height = (int)(PLD(msg).hdr->height / PLD(msg).hdr->scale);
-                auto img = m_imgReader.read(DATA(msg), PLD(msg).hdr->size, PLD(msg).hdr->width, PLD(msg).hdr->height,
-                                            PLD(msg).hdr->scale);
-                if (nullptr != img) {
-                    m_client->setPluginScreen(img, width, height);
+        // the screen connection carries pushed parameter values as well
+        auto msgAny = std::make_shared<Message<Any>>(getLogTagSource());
+        if (msgAny->read(m_socket, &err, 200)) {
+            if (msgAny->getType() == ScreenCapture::Type) {
+                auto msg = Message<Any>::convert<ScreenCapture>(msgAny);
+                if (pPLD(msg).hdr->size > 0) {
+                    int width = (int)(pPLD(msg).hdr->width / pPLD(msg).hdr->scale);
+                    int height = (int)(pPLD(msg).hdr->height / pPLD(msg).hdr->scale);
+                    auto img = m_imgReader.read(pDATA(msg), pPLD(msg).hdr->size, pPLD(msg).hdr->width,
+                                                pPLD(msg).hdr->height, pPLD(msg).hdr->scale);
+                    if (nullptr != img) {
+                        m_client->setPluginScreen(img, width, height);
+                    }
+                } else {
+                    m_client->setPluginScreen(nullptr, 0, 0);
+                }
+            } else if (msgAny->getType() == ParameterValues::Type) {
+                auto msg = Message<Any>::convert<ParameterValues>(msgAny);
+                int idx;
+                auto values = readParameterValues(*msg, idx);
+                if (idx > -1 && values.size() > 0) {
+                    m_client->m_processor->setParameterValues(idx, values);
                 }
             } else {
-                m_client->setPluginScreen(nullptr, 0, 0);
+                logln("unknown message type " << msgAny->getType() << " on screen connection");
             }
         }
     } while (!currentThreadShouldExit() && (err.code == MessageHelper::E_NONE || err.code == MessageHelper::E_TIMEOUT));
@@ -752,26 +1141,143 @@ void Client::sendMouseEvent(MouseEvType ev, Point<float> p, bool isShiftDown, bo
     if (!isReadyLockFree()) {
         return;
     };
-    Message<Mouse> msg(this);
-    DATA(msg)->type = ev;
-    DATA(msg)->x = p.x;
-    DATA(msg)->y = p.y;
-    DATA(msg)->isShiftDown = isShiftDown;
-    DATA(msg)->isCtrlDown = isCtrlDown;
-    DATA(msg)->isAltDown = isAltDown;
+    mouseevent_t e;
+    e.type = ev;
+    e.x = p.x;
+    e.y = p.y;
+    e.isShiftDown = isShiftDown;
+    e.isCtrlDown = isCtrlDown;
+    e.isAltDown = isAltDown;
     if (ev == MouseEvType::WHEEL && nullptr != wheel) {
-        DATA(msg)->deltaX = wheel->deltaX;
-        DATA(msg)->deltaY = wheel->isReversed ? -wheel->deltaY : wheel->deltaY;
-        DATA(msg)->isSmooth = wheel->isSmooth;
+        e.deltaX = wheel->deltaX;
+        e.deltaY = wheel->isReversed ? -wheel->deltaY : wheel->deltaY;
+        e.isSmooth = wheel->isSmooth;
     } else {
-        DATA(msg)->deltaX = 0;
-        DATA(msg)->deltaY = 0;
-        DATA(msg)->isSmooth = false;
+        e.deltaX = 0;
+        e.deltaY = 0;
+        e.isSmooth = false;
+    }
+    // don't block the UI thread, the events are sent by the input sender
+    m_inputSender->add(e);
+}
+
+void Client::sendMouseEvents(const std::vector<mouseevent_t>& events) {
+    traceScope();
+    if (!isReadyLockFree()) {
+        return;
+    };
+    if (!hasCapability(Handshake::CAP_MOUSE_EVENTS)) {
+        // old servers expect a message per event
+        LockByID lock(*this, SENDMOUSEEVENT);
+        for (auto& ev : events) {
+            Message<Mouse> msg(this);
+            *DATA(msg) = ev;
+            msg.send(m_cmd_socket.get());
+        }
+        return;
     }
+    Message<MouseEvents> msg(this);
+    msg.payload.setData(reinterpret_cast<const char*>(events.data()), (int)(events.size() * sizeof(mouseevent_t)));
     LockByID lock(*this, SENDMOUSEEVENT);
     msg.send(m_cmd_socket.get());
 }
 
+void Client::sendKeys(const std::vector<uint16_t>& keys) {
+    traceScope();
+    if (!isReadyLockFree()) {
+        return;
+    };
+    Message<Key> msg(this);
+    PLD(msg).setData(reinterpret_cast<const char*>(keys.data()), static_cast<int>(keys.size() * sizeof(uint16_t)));
+    LockByID lock(*this, KEYPRESSED);
+    msg.send(m_cmd_socket.get());
+}
+
+void Client::InputSender::add(const mouseevent_t& ev) {
+    traceScope();
+    bool mergeable = false;
+    switch (ev.type) {
+        case MouseEvType::MOVE:
+        case MouseEvType::LEFT_DRAG:
+        case MouseEvType::RIGHT_DRAG:
+        case MouseEvType::OTHER_DRAG:
+        case MouseEvType::WHEEL:
+            mergeable = true;
+            break;
+        default:
+            break;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMtx);
+        bool merged = false;
+        if (mergeable && !m_events.empty() && !m_events.back().isKey) {
+            auto& last = m_events.back().mouse;
+            bool sameMods = last.isShiftDown == ev.isShiftDown && last.isCtrlDown == ev.isCtrlDown &&
+                            last.isAltDown == ev.isAltDown;
+            if (sameMods && last.type == ev.type) {
+                if (ev.type != MouseEvType::WHEEL) {
+                    last = ev;
+                    merged = true;
+                } else if (last.isSmooth == ev.isSmooth) {
+                    last.x = ev.x;
+                    last.y = ev.y;
+                    last.deltaX += ev.deltaX;
+                    last.deltaY += ev.deltaY;
+                    merged = true;
+                }
+            }
+        }
+        if (!merged) {
+            // losing a button down or up would leave the plugin UI in a wrong state
+            if (mergeable && m_events.size() >= MAX_EVENTS) {
+                logln("input queue full, dropping event");
+                return;
+            }
+            m_events.push_back({false, ev, {}});
+        }
+    }
+    notify();
+}
+
+void Client::InputSender::add(std::vector<uint16_t>&& keys) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMtx);
+        m_events.push_back({true, {}, std::move(keys)});
+    }
+    notify();
+}
+
+void Client::InputSender::run() {
+    traceScope();
+    std::vector<InputEvent> events;
+    std::vector<mouseevent_t> mouseEvents;
+    while (!threadShouldExit()) {
+        wait(-1);
+        {
+            std::lock_guard<std::mutex> lock(m_eventsMtx);
+            events.swap(m_events);
+        }
+        // consecutive mouse events are sent as one batch, key events in between keep their position
+        for (auto& ev : events) {
+            if (ev.isKey) {
+                if (!mouseEvents.empty()) {
+                    m_client->sendMouseEvents(mouseEvents);
+                    mouseEvents.clear();
+                }
+                m_client->sendKeys(ev.keys);
+            } else {
+                mouseEvents.push_back(ev.mouse);
+            }
+        }
+        if (!mouseEvents.empty()) {
+            m_client->sendMouseEvents(mouseEvents);
+            mouseEvents.clear();
+        }
+        events.clear();
+    }
+}
+
 bool Client::keyPressed(const KeyPress& kp, Component* /* originatingComponent */) {
     if (!isReadyLockFree() || m_processor->getActivePlugin() == -1) {
         traceScope();
@@ -865,11 +1371,8 @@ bool Client::keyPressed(const KeyPress& kp, Component* /* originatingComponent *
         }
     }
 
-    Message<Key> msg(this);
-    PLD(msg).setData(reinterpret_cast<const char*>(keysToPress.data()),
-                     static_cast<int>(keysToPress.size() * sizeof(uint16_t)));
-    LockByID lock(*this, KEYPRESSED);
-    msg.send(m_cmd_socket.get());
+    // don't block the UI thread, the keys are sent by the input sender in order with the mouse events
+    m_inputSender->add(std::move(keysToPress));
 
     return consumed;
 }
@@ -897,6 +1400,29 @@ void Client::restart() {
     msg.send(m_cmd_socket.get());
 }
 
+void Client::readServerCapabilities() {
+    traceScope();
+    m_serverCapabilities = 0;
+    auto msg = std::make_shared<Message<Any>>(this);
+    MessageHelper::Error err;
+    if (!msg->read(m_cmd_socket.get(), &err, 5000)) {
+        logln("failed reading server capabilities: " << err.toString());
+        return;
+    }
+    if (msg->getType() == Capabilities::Type) {
+        auto caps = (uint32)pPLD(Message<Any>::convert<Capabilities>(msg)).getNumber();
+        m_serverCapabilities = caps & Handshake::CAP_ALL;
+        logln("server capabilities: " << String::toHexString((int)caps));
+        updatePluginList();
+    } else if (msg->getType() == PluginList::Type) {
+        // old servers send the plugin list right away
+        logln("the server does not send capabilities, falling back to the old protocol");
+        setPluginList(pPLD(Message<Any>::convert<PluginList>(msg)).getString());
+    } else {
+        logln("unexpected message type " << msg->getType() << " after the handshake");
+    }
+}
+
 void Client::updatePluginList(bool sendRequest) {
     traceScope();
     Message<PluginList> msg(this);
@@ -910,7 +1436,12 @@ void Client::updatePluginList(bool sendRequest) {
         logln("failed reading plugin list: " << err.toString());
         return;
     }
-    String listChunk(PLD(msg).str, as<size_t>(*PLD(msg).size));
+    setPluginList(PLD(msg).getString());
+}
+
+void Client::setPluginList(const String& listChunk) {
+    traceScope();
+    m_plugins.clear();
     auto list = StringArray::fromLines(listChunk);
     for (auto& line : list) {
         if (!line.isEmpty()) {
@@ -950,6 +1481,66 @@ void Client::updateCPULoad() {
     }
 }
 
+void Client::updatePluginStats() {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_PLUGIN_STATS)) {
+        return;
+    };
+    Message<PluginStats> msg(this);
+    MessageHelper::Error err;
+    std::vector<PluginDSPStats> stats;
+    {
+        LockByID lock(*this, UPDATEPLUGINSTATS);
+        msg.send(m_cmd_socket.get());
+        if (!msg.read(m_cmd_socket.get(), &err, 5000)) {
+            logln(getLoadedPluginsString() << ": failed to read PluginStats message: " << err.toString());
+            m_error = true;
+            return;
+        }
+    }
+    for (auto& jstat : PLD(msg).getJson()) {
+        PluginDSPStats s;
+        s.load = jstat["load"].get<float>();
+        s.avg = jstat["avg"].get<float>();
+        s.p99 = jstat["p99"].get<float>();
+        s.max = jstat["max"].get<float>();
+        stats.push_back(s);
+    }
+    m_processor->setPluginStats(stats);
+}
+
+void Client::updateOverloadEvents() {
+    traceScope();
+    if (!isReadyLockFree() || !hasCapability(Handshake::CAP_OVERLOAD_EVENTS)) {
+        return;
+    };
+    Message<OverloadEvents> msg(this);
+    MessageHelper::Error err;
+    {
+        LockByID lock(*this, UPDATEOVERLOADEVENTS);
+        msg.send(m_cmd_socket.get());
+        if (!msg.read(m_cmd_socket.get(), &err, 5000)) {
+            logln(getLoadedPluginsString() << ": failed to read OverloadEvents message: " << err.toString());
+            m_error = true;
+            return;
+        }
+    }
+    auto j = PLD(msg).getJson();
+    StringArray events;
+    for (auto& e : j["events"]) {
+        auto event = String(e.get<std::string>());
+        logln("server: " << event);
+        events.add(event);
+    }
+    Array<int> bypassed;
+    if (jsonHasValue(j, "bypassed")) {
+        for (auto& idx : j["bypassed"]) {
+            bypassed.add(idx.get<int>());
+        }
+    }
+    m_processor->setServerOverload(jsonGetValue(j, "level", 0), events, bypassed);
+}
+
 StreamingSocket* Client::accept(StreamingSocket& sock) const {
     traceScope();
     StreamingSocket* clnt = nullptr;
@@ -132,6 +132,52 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
             return j;
         }
 
+        void write(OutputStream& out) const {
+            out.writeInt(idx);
+            out.writeString(name);
+            out.writeFloat(defaultValue);
+            out.writeInt(category);
+            out.writeString(label);
+            out.writeInt(numSteps);
+            out.writeBool(isBoolean);
+            out.writeBool(isDiscrete);
+            out.writeBool(isMeta);
+            out.writeBool(isOrientInv);
+            out.writeInt(allValues.size());
+            for (auto& s : allValues) {
+                out.writeString(s);
+            }
+            out.writeInt(automationSlot);
+            out.writeFloat(currentValue);
+            out.writeDouble(range.start);
+            out.writeDouble(range.end);
+            out.writeDouble(range.interval);
+        }
+
+        static Parameter read(InputStream& in) {
+            Parameter p;
+            p.idx = in.readInt();
+            p.name = in.readString();
+            p.defaultValue = in.readFloat();
+            p.category = (AudioProcessorParameter::Category)in.readInt();
+            p.label = in.readString();
+            p.numSteps = in.readInt();
+            p.isBoolean = in.readBool();
+            p.isDiscrete = in.readBool();
+            p.isMeta = in.readBool();
+            p.isOrientInv = in.readBool();
+            int numValues = in.readInt();
+            for (int i = 0; i < numValues; i++) {
+                p.allValues.add(in.readString());
+            }
+            p.automationSlot = in.readInt();
+            p.currentValue = in.readFloat();
+            p.range.start = in.readDouble();
+            p.range.end = in.readDouble();
+            p.range.interval = in.readDouble();
+            return p;
+        }
+
         float getValue() const { return (float)range.convertFrom0to1(currentValue); }
 
         void setValue(float val) { currentValue = (float)range.convertTo0to1(val); }
@@ -139,6 +185,10 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     std::atomic_int NUM_OF_BUFFERS{Defaults::DEFAULT_NUM_OF_BUFFERS};
     std::atomic_int LOAD_PLUGIN_TIMEOUT{Defaults::DEFAULT_LOAD_PLUGIN_TIMEOUT};
+    // Minimum number of samples per network transfer, host blocks get aggregated up to this size (0 = host buffer)
+    std::atomic_int NETWORK_FRAME_SIZE{Defaults::DEFAULT_NETWORK_FRAME_SIZE};
+    // Channels below this level are sent as silence markers instead of sample data
+    std::atomic<float> SILENCE_THRESHOLD_DB{Defaults::DEFAULT_SILENCE_THRESHOLD_DB};
 
     void run() override;
 
@@ -151,7 +201,12 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     int getChannelsOut() const { return m_channelsOut; }
     double getSampleRate() const { return m_rate; }
     int getSamplesPerBlock() const { return m_samplesPerBlock; }
-    int getLatencySamples() const { return m_latency + NUM_OF_BUFFERS * m_samplesPerBlock; }
+    int getHostBlockSize() const { return m_hostBlockSize; }
+    int getLatencySamples() const { return m_latency + getBufferingLatencySamples(); }
+    int getBufferingLatencySamples() const {
+        // aggregating host blocks needs to delay the output by the missing part of a frame
+        return NUM_OF_BUFFERS * m_samplesPerBlock + jmax(0, m_samplesPerBlock - m_hostBlockSize);
+    }
     double isUsingDoublePrecission() const { return m_doublePrecission; }
 
     void setLatency(int i) { m_latency = i; }
@@ -179,15 +234,39 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     using OnCloseCallback = std::function<void()>;
     void setOnCloseCallback(OnCloseCallback fn);
 
-    bool addPlugin(String id, StringArray& presets, Array<Parameter>& params, String settings, String& err);
+    bool addPlugin(String id, StringArray& presets, Array<Parameter>& params, const MemoryBlock& settings,
+                   String& err);
+
+    // A plugin to be loaded by loadChain, presets, params, ok and error get updated with the result
+    struct ChainPlugin {
+        String id;
+        const MemoryBlock* settings = nullptr;
+        StringArray* presets = nullptr;
+        Array<Parameter>* params = nullptr;
+        bool ok = false;
+        String error;
+    };
+
+    // Loads all given plugins with a single request. Returns false, if the request failed as a whole.
+    bool loadChain(std::vector<ChainPlugin>& plugins, String& err);
     void delPlugin(int idx);
     void editPlugin(int idx);
     void hidePlugin();
-    MemoryBlock getPluginSettings(int idx);
-    void setPluginSettings(int idx, String settings);
+    // Returns the settings of a plugin. If the hash of the known settings is given, the server sends a delta to the
+    // known settings, if they differ, and an empty block otherwise.
+    MemoryBlock getPluginSettings(int idx, const String& knownHash = {}, const MemoryBlock& knownSettings = {});
+
+    // Sends the settings of a plugin. The settings are sent as delta to the known settings, if the server still has
+    // them.
+    void setPluginSettings(int idx, const MemoryBlock& settings, const String& knownHash = {},
+                           const MemoryBlock& knownSettings = {});
     void bypassPlugin(int idx);
     void unbypassPlugin(int idx);
     void exchangePlugins(int idxA, int idxB);
+    void setParallelBranch(int idx, int group, int branch);
+    void setParallelDry(int group, bool dry);
+    void setBus(const String& sendBus, const String& returnBus);
+    void setSidechain(const String& publish, bool publishOutput, const String& source);
     std::vector<ServerPlugin> getRecents();
     void setPreset(int idx, int preset);
 
@@ -201,6 +280,10 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     Array<ParameterResult> getAllParameterValues(int idx, int count);
 
+    // Subscribes to the parameter changes of a plugin, changed values are pushed by the server and forwarded to the
+    // processor. Only one plugin can be subscribed at a time, a negative index cancels the subscription.
+    void subscribeParameters(int idx);
+
     void updateScreenCaptureArea(int val);
 
     void rescan(bool wipe = false);
@@ -208,9 +291,24 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     void updatePluginList(bool sendRequest = false);
 
+    // Returns true, if the server supports the given protocol extensions (see Handshake::CAPABILITIES)
+    bool hasCapability(uint32 cap) const { return (m_serverCapabilities & cap) == cap; }
+
     void updateCPULoad();
     float getCPULoad() const { return m_srvLoad; }
 
+    struct PluginDSPStats {
+        float load = 0.0f;  // percentage of the block time budget
+        float avg = 0.0f;
+        float p99 = 0.0f;
+        float max = 0.0f;
+    };
+
+    void updatePluginStats();
+
+    // Fetches the actions of the overload protection of the server since the last call
+    void updateOverloadEvents();
+
     // MouseListener
     void mouseMove(const MouseEvent& event) override;
     void mouseEnter(const MouseEvent& event) override;
@@ -251,11 +349,33 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     std::atomic_int m_channelsIn{0};
     std::atomic_int m_channelsOut{0};
     std::atomic_int m_samplesPerBlock{0};
+    std::atomic_int m_hostBlockSize{0};
     std::atomic_int m_latency{0};
 
     std::atomic_bool m_ready{false};
     std::atomic_bool m_error{false};
 
+    std::atomic<uint32> m_serverCapabilities{0};
+
+    // Reads the capabilities, that a server sends after the handshake, followed by the plugin list. Old servers send
+    // the plugin list only.
+    void readServerCapabilities();
+    void setPluginList(const String& listChunk);
+
+    // Updates the parameters from the metadata sent by the server or from the parameter cache, if the server sent the
+    // current values only. The automation slots are kept.
+    bool updateParameters(const String& id, Array<Parameter>& params, const json& j);
+
+    // Requests the full parameter metadata of the plugin at the given index, used when the parameter cache misses.
+    // The caller has to hold the lock of the command socket.
+    bool requestParameters(int idx, const String& id, Array<Parameter>& params, String& err);
+
+    static Array<ParameterResult> readParameterValues(Message<ParameterValues>& msg, int& idx);
+
+    // Sends the hash of the given settings followed by the settings, if the server does not know them
+    bool sendPluginSettings(const MemoryBlock& settings, String& err, const String& knownHash = {},
+                            const MemoryBlock& knownSettings = {});
+
     enum LockID {
         NOLOCK = 0,
         SETPLUGINSCREENUPDATECALLBACK,
@@ -286,7 +406,15 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
         UPDATECPULOAD1,
         UPDATECPULOAD2,
         GETLOADEDPLUGINSSTRING,
-        UPDATEPLUGINLIST
+        UPDATEPLUGINLIST,
+        SETPARALLELBRANCH,
+        UPDATEPLUGINSTATS,
+        SETBUS,
+        SETSIDECHAIN,
+        UPDATEOVERLOADEVENTS,
+        LOADCHAIN,
+        SUBSCRIBEPARAMETERS,
+        SETPARALLELDRY
     };
 
     struct LockByID : public LogTagDelegate {
@@ -372,6 +500,44 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
     };
 
     std::unique_ptr<ScreenReceiver> m_screenWorker;
+
+    // Sends mouse and key events asynchronously and in order. Consecutive moves and drags are merged (latest wins),
+    // wheel events add up. While a batch is being sent, new events queue up and get sent with the next batch. A full
+    // queue drops moves, drags and wheel events only, button and key events are never dropped.
+    class InputSender : public Thread, public LogTagDelegate {
+      public:
+        InputSender(Client* clnt) : Thread("InputSender"), m_client(clnt) {
+            setLogTagSource(clnt);
+            traceScope();
+            startThread();
+        }
+
+        ~InputSender() {
+            traceScope();
+            signalThreadShouldExit();
+            notify();
+            waitForThreadAndLog(m_client, this, 1000);
+        }
+
+        void add(const mouseevent_t& ev);
+        void add(std::vector<uint16_t>&& keys);
+        void run();
+
+      private:
+        struct InputEvent {
+            bool isKey;
+            mouseevent_t mouse;
+            std::vector<uint16_t> keys;
+        };
+
+        Client* m_client;
+        std::vector<InputEvent> m_events;
+        std::mutex m_eventsMtx;
+
+        static constexpr size_t MAX_EVENTS = 256;
+    };
+
+    std::unique_ptr<InputSender> m_inputSender;
     std::shared_ptr<Image> m_pluginScreen;
     ScreenUpdateCallback m_pluginScreenUpdateCallback;
     std::mutex m_pluginScreenMtx;
@@ -384,6 +550,9 @@ class Client : public Thread, public LogTag, public MouseListener, public KeyLis
 
     StreamingSocket* accept(StreamingSocket& sock) const;
 
+    void sendMouseEvents(const std::vector<mouseevent_t>& events);
+    void sendKeys(const std::vector<uint16_t>& keys);
+
     std::mutex m_audioMtx;
     std::shared_ptr<AudioStreamer<float>> m_audioStreamerF;
     std::shared_ptr<AudioStreamer<double>> m_audioStreamerD;
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "ConfigWatcher.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+ConfigWatcher::ConfigWatcher()
+    : Thread("ConfigWatcher"), LogTag("config"), m_file(Defaults::getConfigFileName(Defaults::ConfigPlugin)) {
+    traceScope();
+    // the first instance needs the config right away
+    check();
+    startThread();
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    traceScope();
+    stopThread(-1);
+}
+
+void ConfigWatcher::run() {
+    traceScope();
+    while (!threadShouldExit()) {
+        wait(1000);
+        if (!threadShouldExit()) {
+            check();
+        }
+    }
+}
+
+std::shared_ptr<const json> ConfigWatcher::getConfig(uint64& version) {
+    std::lock_guard<std::mutex> lock(m_cfgMtx);
+    if (version == m_version || nullptr == m_cfg) {
+        return nullptr;
+    }
+    version = m_version;
+    return m_cfg;
+}
+
+void ConfigWatcher::check() {
+    traceScope();
+    if (!m_file.existsAsFile()) {
+        return;
+    }
+    auto modified = m_file.getLastModificationTime();
+    auto size = m_file.getSize();
+    if (modified == m_lastModified && size == m_lastSize) {
+        return;
+    }
+    m_lastModified = modified;
+    m_lastSize = size;
+    auto cfg = std::make_shared<const json>(configParseFile(m_file.getFullPathName()));
+    std::lock_guard<std::mutex> lock(m_cfgMtx);
+    m_cfg = cfg;
+    m_version++;
+    logln("config file changed, version " << m_version);
+}
+
+}  // namespace e47
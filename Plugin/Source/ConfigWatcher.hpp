@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef ConfigWatcher_hpp
+#define ConfigWatcher_hpp
+
+#include <JuceHeader.h>
+
+#include "SharedInstance.hpp"
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Watches the plugin config file for all plugin instances of the process. The file gets checked by its modification
+ * time and size once per second and is parsed only after a change. The instances pick up the parsed config as an
+ * immutable snapshot instead of reading the file themselves.
+ */
+class ConfigWatcher : public Thread, public LogTag, public SharedInstance<ConfigWatcher> {
+  public:
+    ConfigWatcher();
+    ~ConfigWatcher() override;
+
+    void run() override;
+
+    // Returns the current config, if it is newer than the given version, and updates the version. Returns nullptr,
+    // if nothing changed.
+    std::shared_ptr<const json> getConfig(uint64& version);
+
+  private:
+    File m_file;
+    Time m_lastModified;
+    int64 m_lastSize = -1;
+
+    std::shared_ptr<const json> m_cfg;
+    uint64 m_version = 0;
+    std::mutex m_cfgMtx;
+
+    void check();
+};
+
+}  // namespace e47
+
+#endif /* ConfigWatcher_hpp */
@@ -24,6 +24,7 @@ void GenericEditor::resized() {
     traceScope();
     m_labels.clear();
     m_components.clear();
+    m_paramComponents.clear();
     m_clickHandlers.clear();
     int active = m_processor.getActivePlugin();
     if (active < 0) {
@@ -42,8 +43,8 @@ void GenericEditor::resized() {
     int row = 0;
 
     auto& plugin = m_processor.getLoadedPlugin(active);
-    for (int i = 0; i < plugin.params.size(); i++) {
-        auto& param = plugin.params.getReference(i);
+    for (int i = 0; i < plugin.getParams().size(); i++) {
+        auto& param = plugin.getParams().getReference(i);
         if (param.category > AudioProcessorParameter::genericParameter) {
             continue;  // Parameters like meters are not supported for now.
         }
@@ -67,6 +68,7 @@ void GenericEditor::resized() {
             };
 
             addAndMakeVisible(c.get());
+            m_paramComponents[i] = c.get();
             m_components.add(std::move(c));
         } else {
             auto c = std::make_unique<Slider>(Slider::LinearHorizontal, Slider::TextBoxRight);
@@ -96,6 +98,7 @@ void GenericEditor::resized() {
             };
 
             addAndMakeVisible(c.get());
+            m_paramComponents[i] = c.get();
             m_components.add(std::move(c));
 
             String rangeInfo;
@@ -121,12 +124,29 @@ void GenericEditor::resized() {
 
 Client::Parameter& GenericEditor::getParameter(int paramIdx) {
     traceScope();
-    return m_processor.getLoadedPlugin(m_processor.getActivePlugin()).params.getReference(paramIdx);
+    return m_processor.getLoadedPlugin(m_processor.getActivePlugin()).getParams().getReference(paramIdx);
 }
 
 Component* GenericEditor::getComponent(int paramIdx) {
     traceScope();
-    return m_components.getReference(paramIdx).get();
+    auto it = m_paramComponents.find(paramIdx);
+    return it != m_paramComponents.end() ? it->second : nullptr;
+}
+
+void GenericEditor::updateParameterValues(const Array<Client::ParameterResult>& values) {
+    traceScope();
+    for (auto& res : values) {
+        auto* comp = getComponent(res.idx);
+        if (nullptr == comp || comp->isMouseButtonDown()) {
+            continue;  // don't fight with the user
+        }
+        auto& param = getParameter(res.idx);
+        if (auto* c = dynamic_cast<ComboBox*>(comp)) {
+            c->setSelectedId((int)param.getValue() + 1, NotificationType::dontSendNotification);
+        } else if (auto* s = dynamic_cast<Slider*>(comp)) {
+            s->setValue(param.getValue(), NotificationType::dontSendNotification);
+        }
+    }
 }
 
 void GenericEditor::updateParameter(int paramIdx) {
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <unordered_map>
 
 #include "PluginProcessor.hpp"
 #include "Tracer.hpp"
@@ -22,11 +23,15 @@ class GenericEditor : public Component, public LogTag {
     void paint(juce::Graphics&) override;
     void resized() override;
 
+    // Updates the components of the given parameters from their current values
+    void updateParameterValues(const Array<Client::ParameterResult>& values);
+
   private:
     AudioGridderAudioProcessor& m_processor;
 
     Array<std::unique_ptr<Component>> m_labels;
     Array<std::unique_ptr<Component>> m_components;
+    std::unordered_map<int, Component*> m_paramComponents;
     struct OnClick : public MouseListener, public LogTagDelegate {
         std::function<void()> func;
         OnClick(std::function<void()> f) : func(f) {}
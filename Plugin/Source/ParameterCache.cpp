@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "ParameterCache.hpp"
+#include "Defaults.hpp"
+
+namespace e47 {
+
+std::unordered_map<String, ParameterCache::Entry> ParameterCache::m_entries;
+std::mutex ParameterCache::m_mtx;
+
+String ParameterCache::getVersion(const String& id) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto* entry = load(id);
+    return nullptr != entry ? entry->version : String();
+}
+
+bool ParameterCache::get(const String& id, const String& version, json& jparams) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto* entry = load(id);
+    if (nullptr == entry || entry->version != version) {
+        return false;
+    }
+    jparams = entry->params;
+    return true;
+}
+
+void ParameterCache::put(const String& id, const String& version, const json& jparams) {
+    setLogTagStatic("paramcache");
+    if (version.isEmpty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto* entry = load(id);
+    if (nullptr != entry && entry->version == version) {
+        return;
+    }
+    m_entries[id] = {version, jparams};
+    auto dir = File(Defaults::PARAMS_CACHE_DIR);
+    if (!dir.exists() && !dir.createDirectory()) {
+        logln("failed to create cache directory " << dir.getFullPathName());
+        return;
+    }
+    json j = {{"id", id.toStdString()}, {"version", version.toStdString()}, {"parameters", jparams}};
+    configWriteFile(getFile(id).getFullPathName(), j);
+}
+
+File ParameterCache::getFile(const String& id) {
+    SHA256 sha(id.toUTF8());
+    return File(Defaults::PARAMS_CACHE_DIR).getChildFile(sha.toHexString() + ".json");
+}
+
+ParameterCache::Entry* ParameterCache::load(const String& id) {
+    auto it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        return &it->second;
+    }
+    auto file = getFile(id);
+    if (!file.existsAsFile()) {
+        return nullptr;
+    }
+    auto j = configParseFile(file.getFullPathName());
+    // the file name is a hash, make sure it belongs to this plugin
+    if (jsonGetValue(j, "id", String()) != id || !jsonHasValue(j, "parameters")) {
+        return nullptr;
+    }
+    auto& entry = m_entries[id];
+    entry.version = jsonGetValue(j, "version", String());
+    entry.params = j["parameters"];
+    return &entry;
+}
+
+}  // namespace e47
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef ParameterCache_hpp
+#define ParameterCache_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Persistent cache for the parameter metadata of plugins. The metadata of a plugin is stored on disk by its plugin ID
+ * together with the version, that the server calculated for it. When loading a plugin, the client announces the
+ * cached version and the server sends the current parameter values only, if the version is still valid.
+ */
+class ParameterCache {
+  public:
+    // Returns the cached version for the given plugin or an empty string
+    static String getVersion(const String& id);
+
+    static bool get(const String& id, const String& version, json& jparams);
+    static void put(const String& id, const String& version, const json& jparams);
+
+  private:
+    struct Entry {
+        String version;
+        json params;
+    };
+
+    static std::unordered_map<String, Entry> m_entries;
+    static std::mutex m_mtx;
+
+    static File getFile(const String& id);
+    static Entry* load(const String& id);
+};
+
+}  // namespace e47
+
+#endif /* ParameterCache_hpp */
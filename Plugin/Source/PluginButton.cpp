@@ -7,6 +7,7 @@
 
 #include "PluginButton.hpp"
 #include "NumberConversion.hpp"
+#include "Defaults.hpp"
 
 using namespace e47;
 
@@ -91,6 +92,21 @@ void PluginButton::paintButton(Graphics& g, bool shouldDrawButtonAsHighlighted,
         g.drawLine(rect.getX(), rect.getBottom(), rect.getRight(), rect.getY(), 0.7f);
     }
 
+    if (m_load >= 0.0f) {
+        uint32 col;
+        if (m_load < 50.0f) {
+            col = Defaults::CPU_LOW_COLOR;
+        } else if (m_load < 90.0f) {
+            col = Defaults::CPU_MEDIUM_COLOR;
+        } else {
+            col = Defaults::CPU_HIGH_COLOR;
+        }
+        int barMaxWidth = getWidth() - textIndentLeft - textIndentRight;
+        int barWidth = roundToInt(jmin(m_load, 100.0f) / 100.0f * as<float>(barMaxWidth));
+        g.setColour(Colour(col).withAlpha(0.6f));
+        g.fillRect(textIndentLeft, getHeight() - 2, barWidth, 2);
+    }
+
     drawText(g, textIndentLeft, textIndentRight);
 }
 
@@ -105,8 +121,11 @@ void PluginButton::drawText(Graphics& g, int left, int right) {
     auto& lf = getLookAndFeel();
     Font font(lf.getTextButtonFont(*this, getHeight()));
     g.setFont(font);
-    g.setColour(findColour(getToggleState() ? TextButton::textColourOnId : TextButton::textColourOffId)
-                    .withMultipliedAlpha(isEnabled() ? 1.0f : 0.5f));
+    auto textColour = findColour(getToggleState() ? TextButton::textColourOnId : TextButton::textColourOffId);
+    if (m_serverBypassed) {
+        textColour = Colour(Defaults::CPU_HIGH_COLOR);
+    }
+    g.setColour(textColour.withMultipliedAlpha(isEnabled() ? 1.0f : 0.5f));
 
     const int yIndent = jmin(4, proportionOfHeight(0.3f));
     const int cornerSize = jmin(getHeight(), getWidth()) / 2;
@@ -41,6 +41,23 @@ class PluginButton : public TextButton {
     }
     bool isEnabled() const { return m_enabled; }
 
+    // Processing load of the plugin in percent of the block time budget, a negative value hides the load bar
+    void setLoad(float load) {
+        if (load != m_load) {
+            m_load = load;
+            repaint();
+        }
+    }
+
+    // The server has bypassed the plugin to reduce its load, this is independent of the bypass by the user
+    void setServerBypassed(bool b) {
+        if (b != m_serverBypassed) {
+            m_serverBypassed = b;
+            repaint();
+        }
+    }
+    bool isServerBypassed() const { return m_serverBypassed; }
+
   protected:
     void paintButton(Graphics& g, bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override;
     void clicked(const ModifierKeys& modifiers) override;
@@ -53,6 +70,8 @@ class PluginButton : public TextButton {
     Listener* m_listener = nullptr;
     bool m_active = false;
     bool m_enabled = true;
+    float m_load = -1.0f;
+    bool m_serverBypassed = false;
     String m_id;
     bool m_withExtraButtons = true;
     Rectangle<int> m_bypassArea, m_moveUpArea, m_moveDownArea, m_deleteArea;
@@ -429,6 +429,32 @@ void AudioGridderAudioProcessorEditor::buttonClicked(Button* button, const Modif
             m.addSeparator();
             m.addItem("Move Up", idx > 0, false, moveUpFn);
             m.addItem("Move Down", as<size_t>(idx) < m_pluginButtons.size() - 1, false, moveDownFn);
+            PopupMenu routing;
+            auto& plug = m_processor.getLoadedPlugin(idx);
+            routing.addItem("Serial", true, plug.parallelGroup == 0, [this, idx] {
+                traceScope();
+                m_processor.setParallelBranch(idx, 0, 0);
+            });
+            for (int group = 1; group <= Defaults::MAX_PARALLEL_GROUPS; group++) {
+                PopupMenu branches;
+                for (int branch = 0; branch < Defaults::MAX_PARALLEL_BRANCHES; branch++) {
+                    branches.addItem("Branch " + String(branch + 1), true,
+                                     plug.parallelGroup == group && plug.parallelBranch == branch,
+                                     [this, idx, group, branch] {
+                                         traceScope();
+                                         m_processor.setParallelBranch(idx, group, branch);
+                                     });
+                }
+                branches.addSeparator();
+                bool dry = m_processor.isParallelDry(group);
+                branches.addItem("Dry Branch", true, dry, [this, group, dry] {
+                    traceScope();
+                    m_processor.setParallelDry(group, !dry);
+                });
+                routing.addSubMenu("Parallel Group " + String(group), branches, true, nullptr,
+                                   plug.parallelGroup == group);
+            }
+            m.addSubMenu("Routing", routing);
             m.addSeparator();
             m.addItem("Delete", deleteFn);
             m.addSeparator();
@@ -444,7 +470,7 @@ void AudioGridderAudioProcessorEditor::buttonClicked(Button* button, const Modif
             m.addSubMenu("Presets", presets);
             m.addSeparator();
             PopupMenu params;
-            for (auto& p : m_processor.getLoadedPlugin(idx).params) {
+            for (auto& p : m_processor.getLoadedPlugin(idx).getParams()) {
                 int paramIdx = p.idx;
                 String name = p.name;
                 bool enabled = false;
@@ -559,8 +585,10 @@ void AudioGridderAudioProcessorEditor::setConnected(bool connected) {
     } else {
         m_srvLabel.setText("not connected", NotificationType::dontSendNotification);
         setCPULoad(0.0f);
+        setPluginStats({});
         for (auto& but : m_pluginButtons) {
             but->setEnabled(false);
+            but->setServerBypassed(false);
         }
     }
 }
@@ -581,6 +609,51 @@ void AudioGridderAudioProcessorEditor::setCPULoad(float load) {
     m_cpuLabel.setColour(Label::textColourId, Colour(col));
 }
 
+void AudioGridderAudioProcessorEditor::setParameterValues(int idx, const Array<Client::ParameterResult>& values) {
+    traceScope();
+    if (m_processor.getGenericEditor() && idx == m_processor.getActivePlugin()) {
+        m_genericEditor.updateParameterValues(values);
+    }
+}
+
+void AudioGridderAudioProcessorEditor::setPluginStats(const std::vector<Client::PluginDSPStats>& stats) {
+    traceScope();
+    for (size_t i = 0; i < m_pluginButtons.size(); i++) {
+        auto& b = m_pluginButtons[i];
+        if (m_connected && i < stats.size()) {
+            auto& s = stats[i];
+            b->setLoad(s.load);
+            String tip;
+            tip << "DSP load: " << String(s.load, 1) << "% of block time" << newLine << "avg: " << String(s.avg, 3)
+                << " ms, 99th: " << String(s.p99, 3) << " ms, max: " << String(s.max, 3) << " ms";
+            if (b->isServerBypassed()) {
+                tip << newLine << "Bypassed by the server to reduce its load";
+            }
+            b->setTooltip(tip);
+        } else {
+            b->setLoad(-1.0f);
+            b->setTooltip({});
+        }
+    }
+}
+
+void AudioGridderAudioProcessorEditor::setServerOverload(int level, const StringArray& events,
+                                                         const Array<int>& bypassed) {
+    traceScope();
+    for (int i = 0; i < (int)m_pluginButtons.size(); i++) {
+        m_pluginButtons[(size_t)i]->setServerBypassed(bypassed.contains(i));
+    }
+    String tip;
+    if (level > 0) {
+        tip << "The server is overloaded and degrades its service." << newLine;
+    }
+    if (!events.isEmpty()) {
+        tip << "Recent overload actions of the server:" << newLine << events.joinIntoString(newLine);
+    }
+    m_cpuLabel.setTooltip(tip);
+    m_cpuIcon.setTooltip(tip);
+}
+
 void AudioGridderAudioProcessorEditor::mouseUp(const MouseEvent& event) {
     traceScope();
     if (event.eventComponent == &m_srvIcon) {
@@ -588,7 +661,7 @@ void AudioGridderAudioProcessorEditor::mouseUp(const MouseEvent& event) {
         m.addSectionHeader("Buffering");
         PopupMenu bufMenu;
         int rate = as<int>(lround(m_processor.getSampleRate()));
-        int iobuf = m_processor.getBlockSize();
+        int iobuf = jmax(m_processor.getBlockSize(), m_processor.getClient().getSamplesPerBlock());
         auto getName = [rate, iobuf](int blocks) -> String {
             String n;
             n << blocks << " Blocks (+" << blocks * iobuf * 1000 / rate << "ms)";
@@ -639,6 +712,85 @@ void AudioGridderAudioProcessorEditor::mouseUp(const MouseEvent& event) {
             m_processor.saveConfig(30);
         });
         m.addSubMenu("Buffer Size", bufMenu);
+        PopupMenu frameMenu;
+        int frameSize = m_processor.getClient().NETWORK_FRAME_SIZE;
+        frameMenu.addItem("Host Buffer Size", true, frameSize == 0, [this] {
+            traceScope();
+            m_processor.setNetworkFrameSize(0);
+        });
+        for (int n : {64, 128, 256, 512, 1024}) {
+            String name;
+            name << n << " Samples";
+            frameMenu.addItem(name, n > m_processor.getBlockSize(), frameSize == n, [this, n] {
+                traceScope();
+                m_processor.setNetworkFrameSize(n);
+            });
+        }
+        m.addSubMenu("Network Frame Size", frameMenu);
+        m.addSectionHeader("Shared Bus");
+        auto sendBus = m_processor.getSendBus();
+        auto returnBus = m_processor.getReturnBus();
+        PopupMenu sendMenu, returnMenu;
+        sendMenu.addItem("None", true, sendBus.isEmpty(), [this, returnBus] {
+            traceScope();
+            m_processor.setBus("", returnBus);
+        });
+        returnMenu.addItem("None", true, returnBus.isEmpty(), [this, sendBus] {
+            traceScope();
+            m_processor.setBus(sendBus, "");
+        });
+        for (int i = 1; i <= Defaults::NUM_OF_SHARED_BUSES; i++) {
+            String bus = "Bus ";
+            bus << i;
+            sendMenu.addItem(bus, bus != returnBus, sendBus == bus, [this, bus, returnBus] {
+                traceScope();
+                m_processor.setBus(bus, returnBus);
+            });
+            returnMenu.addItem(bus, bus != sendBus, returnBus == bus, [this, bus, sendBus] {
+                traceScope();
+                m_processor.setBus(sendBus, bus);
+            });
+        }
+        m.addSubMenu("Send to Bus", sendMenu);
+        m.addSubMenu("Return from Bus", returnMenu);
+        m.addSectionHeader("Sidechain");
+        auto sidechain = m_processor.getSidechain();
+        PopupMenu publishMenu, sourceMenu;
+        publishMenu.addItem("None", true, sidechain.publish.isEmpty(), [this, sidechain] {
+            traceScope();
+            auto cfg = sidechain;
+            cfg.publish = "";
+            m_processor.setSidechain(cfg);
+        });
+        sourceMenu.addItem("None", true, sidechain.source.isEmpty(), [this, sidechain] {
+            traceScope();
+            auto cfg = sidechain;
+            cfg.source = "";
+            m_processor.setSidechain(cfg);
+        });
+        for (int i = 1; i <= Defaults::NUM_OF_SIDECHAIN_SOURCES; i++) {
+            String name = "Sidechain ";
+            name << i;
+            for (bool output : {false, true}) {
+                String item = name + (output ? " (Output)" : " (Input)");
+                bool ticked = sidechain.publish == name && sidechain.publishOutput == output;
+                publishMenu.addItem(item, name != sidechain.source, ticked, [this, sidechain, name, output] {
+                    traceScope();
+                    auto cfg = sidechain;
+                    cfg.publish = name;
+                    cfg.publishOutput = output;
+                    m_processor.setSidechain(cfg);
+                });
+            }
+            sourceMenu.addItem(name, name != sidechain.publish, sidechain.source == name, [this, sidechain, name] {
+                traceScope();
+                auto cfg = sidechain;
+                cfg.source = name;
+                m_processor.setSidechain(cfg);
+            });
+        }
+        m.addSubMenu("Publish as Sidechain", publishMenu);
+        m.addSubMenu("Sidechain Input", sourceMenu);
         m.addSectionHeader("Servers");
         auto& servers = m_processor.getServers();
         auto active = m_processor.getActiveServerHost();
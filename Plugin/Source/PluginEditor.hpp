@@ -34,6 +34,9 @@ class AudioGridderAudioProcessorEditor : public AudioProcessorEditor,
 
     void setConnected(bool connected);
     void setCPULoad(float load);
+    void setPluginStats(const std::vector<Client::PluginDSPStats>& stats);
+    void setServerOverload(int level, const StringArray& events, const Array<int>& bypassed);
+    void setParameterValues(int idx, const Array<Client::ParameterResult>& values);
 
   private:
     AudioGridderAudioProcessor& m_processor;
@@ -51,6 +54,7 @@ class AudioGridderAudioProcessorEditor : public AudioProcessorEditor,
     Label m_srvLabel, m_versionLabel, m_cpuLabel;
     ImageComponent m_logo;
     bool m_connected = false;
+    TooltipWindow m_tooltipWindow{this};
 
     struct ToolsButton : TextButton {
         void paintButton(Graphics& g, bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override;
@@ -16,6 +16,7 @@
 #include "AudioStreamer.hpp"
 #include "PluginMonitor.hpp"
 #include "WindowPositions.hpp"
+#include "ConfigWatcher.hpp"
 
 #if !defined(JUCE_WINDOWS)
 #include <signal.h>
@@ -29,44 +30,15 @@ AudioGridderAudioProcessor::AudioGridderAudioProcessor()
                          .withInput("Input", AudioChannelSet::stereo(), true)
 #endif
                          .withOutput("Output", AudioChannelSet::stereo(), true)) {
+    // Hosts create hundreds of instances when opening big projects, so everything, that is not needed to restore the
+    // state, gets set up by startClient
     initAsyncFunctors();
 
-    String mode;
-#if JucePlugin_IsSynth
-    mode = "Instrument";
-#elif JucePlugin_IsMidiEffect
-    mode = "Midi";
-#else
-    mode = "FX";
-#endif
-
-    String appName = mode;
-    String logName = "AudioGridderPlugin_";
-
-    AGLogger::initialize(appName, logName, Defaults::getConfigFileName(Defaults::ConfigPlugin));
-    Tracer::initialize(appName, logName);
-    Signals::initialize();
-    CoreDump::initialize(appName, logName, true);
-    Metrics::initialize();
-    WindowPositions::initialize();
-    PluginMonitor::initialize();
+    ConfigWatcher::initialize();
 
     m_client = std::make_unique<Client>(this);
     setLogTagSource(m_client.get());
     traceScope();
-    logln(mode << " plugin loaded (version: " << AUDIOGRIDDER_VERSION << ", build date: " << AUDIOGRIDDER_BUILD_DATE
-               << ")");
-
-    ServiceReceiver::initialize(m_instId.hash(), [this] {
-        traceScope();
-        runOnMsgThreadAsync([this] {
-            traceScope();
-            auto* editor = getActiveEditor();
-            if (editor != nullptr) {
-                dynamic_cast<AudioGridderAudioProcessorEditor*>(editor)->setConnected(m_client->isReadyLockFree());
-            }
-        });
-    });
 
     updateLatency(0);
 
@@ -86,26 +58,44 @@ AudioGridderAudioProcessor::AudioGridderAudioProcessor()
     m_client->setOnConnectCallback(safeLambda([this] {
         traceScope();
         logln("connected");
+        // the new server connection has no subscription
+        m_subscribedPlugin = -1;
         bool updLatency = false;
         std::vector<std::tuple<int, int, int>> automationParams;
         int idx = 0;
         {
             std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+            // load all plugins with a single request
+            std::vector<Client::ChainPlugin> chain;
             for (auto& p : m_loadedPlugins) {
-                logln("loading " << p.name << " (" << p.id << ") [on connect]... ");
+                chain.push_back({p.id, &p.settings, &p.presets, &p.getParams()});
+            }
+            if (!chain.empty()) {
+                logln("loading " << chain.size() << " plugins [on connect]...");
                 String err;
-                p.ok = m_client->addPlugin(p.id, p.presets, p.params, p.settings, err);
+                if (!m_client->loadChain(chain, err)) {
+                    for (auto& c : chain) {
+                        c.error = err;
+                    }
+                }
+            }
+            for (size_t i = 0; i < chain.size(); i++) {
+                auto& p = m_loadedPlugins[i];
+                p.ok = chain[i].ok;
                 if (p.ok) {
-                    logln("...ok");
+                    logln("loaded " << p.name << " (" << p.id << ")");
                 } else {
-                    logln("...failed: " << err);
+                    logln("loading " << p.name << " (" << p.id << ") failed: " << chain[i].error);
                 }
                 if (p.ok) {
                     updLatency = true;
                     if (p.bypassed) {
                         m_client->bypassPlugin(idx);
                     }
-                    for (auto& param : p.params) {
+                    if (p.parallelGroup > 0) {
+                        m_client->setParallelBranch(idx, p.parallelGroup, p.parallelBranch);
+                    }
+                    for (auto& param : p.getParams()) {
                         if (param.automationSlot > -1) {
                             if (param.automationSlot < m_numberOfAutomationSlots) {
                                 automationParams.push_back({idx, param.idx, param.automationSlot});
@@ -117,6 +107,9 @@ AudioGridderAudioProcessor::AudioGridderAudioProcessor()
                 }
                 idx++;
             }
+            for (auto group : m_parallelDryGroups) {
+                m_client->setParallelDry(group, true);
+            }
         }
         m_client->setLoadedPluginsString(getLoadedPluginsString());
 
@@ -124,10 +117,25 @@ AudioGridderAudioProcessor::AudioGridderAudioProcessor()
             enableParamAutomation(std::get<0>(ap), std::get<1>(ap), std::get<2>(ap));
         }
 
+        auto sendBus = getSendBus();
+        auto returnBus = getReturnBus();
+        if (sendBus.isNotEmpty() || returnBus.isNotEmpty()) {
+            m_client->setBus(sendBus, returnBus);
+        }
+        auto sidechain = getSidechain();
+        if (sidechain.publish.isNotEmpty() || sidechain.source.isNotEmpty()) {
+            m_client->setSidechain(sidechain.publish, sidechain.publishOutput, sidechain.source);
+        }
+
         if (updLatency) {
             updateLatency(m_client->getLatencySamples());
         }
 
+        // restore the subscription of the generic editor
+        if (m_genericEditor && m_activePlugin > -1 && getLoadedPlugin(m_activePlugin).ok) {
+            subscribeParameters(m_activePlugin);
+        }
+
         runOnMsgThreadAsync([this] {
             traceScope();
             auto* editor = getActiveEditor();
@@ -156,9 +164,7 @@ AudioGridderAudioProcessor::AudioGridderAudioProcessor()
         m_client->setServer(m_servers[m_activeServerLegacyFromCfg]);
     }
 
-    m_client->startThread();
-
-    PluginMonitor::add(this);
+    // the client gets started on demand, so that instances, that are never used, don't connect
 }
 
 AudioGridderAudioProcessor::~AudioGridderAudioProcessor() {
@@ -170,21 +176,73 @@ AudioGridderAudioProcessor::~AudioGridderAudioProcessor() {
     m_client->close();
     waitForThreadAndLog(m_client.get(), m_client.get());
     logln("plugin shutdown: cleaning up");
-    PluginMonitor::cleanup();
-    WindowPositions::cleanup();
-    Metrics::cleanup();
-    ServiceReceiver::cleanup(m_instId.hash());
-    logln("plugin unloaded");
-    Tracer::cleanup();
-    AGLogger::cleanup();
+    ConfigWatcher::cleanup();
+    if (m_clientStarted) {
+        PluginMonitor::cleanup();
+        WindowPositions::cleanup();
+        Metrics::cleanup();
+        ServiceReceiver::cleanup(m_instId.hash());
+        logln("plugin unloaded");
+        Tracer::cleanup();
+        AGLogger::cleanup();
+    }
 }
 
 void AudioGridderAudioProcessor::loadConfig() {
     traceScope();
-    auto cfg = configParseFile(Defaults::getConfigFileName(Defaults::ConfigPlugin));
-    if (cfg.size() > 0) {
-        loadConfig(cfg);
+    // the config file is parsed once for all instances
+    uint64 version = 0;
+    auto watcher = ConfigWatcher::getInstance();
+    auto cfg = nullptr != watcher ? watcher->getConfig(version) : nullptr;
+    if (nullptr != cfg && cfg->size() > 0) {
+        loadConfig(*cfg);
+    }
+}
+
+void AudioGridderAudioProcessor::startClient() {
+    traceScope();
+    if (m_clientStarted.exchange(true)) {
+        return;
     }
+
+    String mode;
+#if JucePlugin_IsSynth
+    mode = "Instrument";
+#elif JucePlugin_IsMidiEffect
+    mode = "Midi";
+#else
+    mode = "FX";
+#endif
+
+    String appName = mode;
+    String logName = "AudioGridderPlugin_";
+
+    AGLogger::initialize(appName, logName, Defaults::getConfigFileName(Defaults::ConfigPlugin));
+    Tracer::initialize(appName, logName);
+    Signals::initialize();
+    CoreDump::initialize(appName, logName, true);
+    Metrics::initialize();
+    WindowPositions::initialize();
+    PluginMonitor::initialize();
+
+    logln(mode << " plugin loaded (version: " << AUDIOGRIDDER_VERSION << ", build date: " << AUDIOGRIDDER_BUILD_DATE
+               << ")");
+
+    ServiceReceiver::initialize(m_instId.hash(), [this] {
+        traceScope();
+        runOnMsgThreadAsync([this] {
+            traceScope();
+            auto* editor = getActiveEditor();
+            if (editor != nullptr) {
+                dynamic_cast<AudioGridderAudioProcessorEditor*>(editor)->setConnected(m_client->isReadyLockFree());
+            }
+        });
+    });
+
+    PluginMonitor::add(this);
+
+    logln("starting client");
+    m_client->startThread();
 }
 
 void AudioGridderAudioProcessor::loadConfig(const json& j, bool isUpdate) {
@@ -208,12 +266,14 @@ void AudioGridderAudioProcessor::loadConfig(const json& j, bool isUpdate) {
         m_activeServerLegacyFromCfg = jsonGetValue(j, "Last", m_activeServerLegacyFromCfg);
         m_client->NUM_OF_BUFFERS = jsonGetValue(j, "NumberOfBuffers", m_client->NUM_OF_BUFFERS.load());
         m_client->LOAD_PLUGIN_TIMEOUT = jsonGetValue(j, "LoadPluginTimeoutMS", m_client->LOAD_PLUGIN_TIMEOUT.load());
+        m_client->NETWORK_FRAME_SIZE = jsonGetValue(j, "NetworkFrameSize", m_client->NETWORK_FRAME_SIZE.load());
 
         if (m_scale != Desktop::getInstance().getGlobalScaleFactor()) {
             Desktop::getInstance().setGlobalScaleFactor(m_scale);
         }
     }
 
+    m_client->SILENCE_THRESHOLD_DB = jsonGetValue(j, "SilenceThresholdDB", m_client->SILENCE_THRESHOLD_DB.load());
     m_numberOfAutomationSlots = jsonGetValue(j, "NumberOfAutomationSlots", m_numberOfAutomationSlots);
     m_menuShowCategory = jsonGetValue(j, "MenuShowCategory", m_menuShowCategory);
     m_menuShowCompany = jsonGetValue(j, "MenuShowCompany", m_menuShowCompany);
@@ -244,6 +304,8 @@ void AudioGridderAudioProcessor::saveConfig(int numOfBuffers) {
     jcfg["Servers"] = jservers;
     jcfg["LastServer"] = m_client->getServerHostAndID().toStdString();
     jcfg["NumberOfBuffers"] = numOfBuffers;
+    jcfg["NetworkFrameSize"] = m_client->NETWORK_FRAME_SIZE.load();
+    jcfg["SilenceThresholdDB"] = m_client->SILENCE_THRESHOLD_DB.load();
     jcfg["NumberOfAutomationSlots"] = m_numberOfAutomationSlots;
     jcfg["LoadPluginTimeoutMS"] = m_client->LOAD_PLUGIN_TIMEOUT.load();
     jcfg["MenuShowCategory"] = m_menuShowCategory;
@@ -262,6 +324,15 @@ void AudioGridderAudioProcessor::saveConfig(int numOfBuffers) {
     configWriteFile(Defaults::getConfigFileName(Defaults::ConfigPlugin), jcfg);
 }
 
+void AudioGridderAudioProcessor::setNetworkFrameSize(int n) {
+    traceScope();
+    if (m_client->NETWORK_FRAME_SIZE != n) {
+        m_client->NETWORK_FRAME_SIZE = n;
+        saveConfig();
+        m_client->reconnect();
+    }
+}
+
 const String AudioGridderAudioProcessor::getName() const {
     auto pluginStr = getLoadedPluginsString();
     if (pluginStr.isNotEmpty()) {
@@ -303,6 +374,7 @@ void AudioGridderAudioProcessor::prepareToPlay(double sampleRate, int samplesPer
     m_client->init(getTotalNumInputChannels(), getTotalNumOutputChannels(), sampleRate, samplesPerBlock,
                    isUsingDoublePrecision());
     m_prepared = true;
+    startClient();
 }
 
 void AudioGridderAudioProcessor::releaseResources() {
@@ -482,54 +554,199 @@ void AudioGridderAudioProcessor::updateLatency(int samples) {
 
 bool AudioGridderAudioProcessor::hasEditor() const { return true; }
 
-AudioProcessorEditor* AudioGridderAudioProcessor::createEditor() { return new AudioGridderAudioProcessorEditor(*this); }
+AudioProcessorEditor* AudioGridderAudioProcessor::createEditor() {
+    startClient();
+    return new AudioGridderAudioProcessorEditor(*this);
+}
 
 void AudioGridderAudioProcessor::getStateInformation(MemoryBlock& destData) {
     traceScope();
+    TimeStatistic::Duration duration(Metrics::getStatistic<TimeStatistic>("StateSave"));
+    writeState(destData);
+    duration.finish();
+    saveConfig();
+}
 
-    json j;
-    auto jservers = json::array();
+void AudioGridderAudioProcessor::writeState(MemoryBlock& destData) {
+    traceScope();
+    MemoryOutputStream body;
+    body.writeInt(m_servers.size());
     for (auto& srv : m_servers) {
-        jservers.push_back(srv.toStdString());
+        body.writeString(srv);
+    }
+    body.writeString(m_client->getServerHostAndID());
+    {
+        std::lock_guard<std::mutex> lock(m_busMtx);
+        body.writeString(m_sendBus);
+        body.writeString(m_returnBus);
+        body.writeString(m_sidechain.publish);
+        body.writeBool(m_sidechain.publishOutput);
+        body.writeString(m_sidechain.source);
     }
-    j["version"] = 2;
-    j["servers"] = jservers;
-    j["activeServerStr"] = m_client->getServerHostAndID().toStdString();
-    auto jplugs = json::array();
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        body.writeInt((int)m_loadedPlugins.size());
         for (int i = 0; i < (int)m_loadedPlugins.size(); i++) {
             auto& plug = m_loadedPlugins[(size_t)i];
             if (plug.ok && m_client->isReadyLockFree()) {
-                auto settings = m_client->getPluginSettings(i);
-                if (settings.getSize() > 0) {
-                    plug.settings = settings.toBase64Encoding();
-                }
+                syncPluginSettings(i, plug);
             }
-            auto jpresets = json::array();
+            body.writeString(plug.id);
+            body.writeString(plug.name);
+            body.writeInt((int)plug.settings.getSize());
+            body.write(plug.settings.getData(), plug.settings.getSize());
+            body.writeInt(plug.presets.size());
             for (auto& p : plug.presets) {
-                jpresets.push_back(p.toStdString());
+                body.writeString(p);
             }
-            auto jparams = json::array();
-            for (auto& p : plug.params) {
-                jparams.push_back(p.toJson());
+            {
+                // parameters, that have not been decoded yet, are written as they are
+                std::lock_guard<std::mutex> paramsLock(*plug.paramsMtx);
+                if (plug.paramsData.getSize() > 0) {
+                    body.writeInt((int)plug.paramsData.getSize());
+                    body.write(plug.paramsData.getData(), plug.paramsData.getSize());
+                } else {
+                    MemoryOutputStream params;
+                    params.writeInt(plug.params.size());
+                    for (auto& p : plug.params) {
+                        p.write(params);
+                    }
+                    body.writeInt((int)params.getDataSize());
+                    body.write(params.getData(), params.getDataSize());
+                }
             }
-            jplugs.push_back({plug.id.toStdString(), plug.name.toStdString(), plug.settings.toStdString(), jpresets,
-                              jparams, plug.bypassed});
+            body.writeBool(plug.bypassed);
+            body.writeInt(plug.parallelGroup);
+            body.writeInt(plug.parallelBranch);
+        }
+        // appended to the body, older versions ignore it
+        body.writeInt((int)m_parallelDryGroups.size());
+        for (auto group : m_parallelDryGroups) {
+            body.writeInt(group);
         }
     }
-    j["loadedPlugins"] = jplugs;
-
-    auto dump = j.dump();
-    destData.append(dump.data(), dump.length());
 
-    saveConfig();
+    MemoryOutputStream out(destData, true);
+    out.writeInt(STATE_MAGIC);
+    out.writeInt(STATE_VERSION);
+    if (body.getDataSize() > STATE_COMPRESS_MIN_SIZE) {
+        out.writeInt(STATE_FLAG_COMPRESSED);
+        GZIPCompressorOutputStream gz(out, 1);
+        gz.write(body.getData(), body.getDataSize());
+    } else {
+        out.writeInt(0);
+        out.write(body.getData(), body.getDataSize());
+    }
 }
 
 void AudioGridderAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
     traceScope();
+    TimeStatistic::Duration duration(Metrics::getStatistic<TimeStatistic>("StateLoad"));
+    String activeServerStr;
+    int activeServer = -1;
+    if (!readState(data, sizeInBytes, activeServerStr)) {
+        // the state has been stored by an older version
+        readStateJson(data, sizeInBytes, activeServerStr, activeServer);
+    }
+    duration.finish();
+    if (activeServerStr.isNotEmpty()) {
+        m_client->setServer(activeServerStr);
+        m_client->reconnect();
+    } else if (activeServer > -1 && activeServer < m_servers.size()) {
+        m_client->setServer(m_servers[activeServer]);
+        m_client->reconnect();
+    }
+}
 
+bool AudioGridderAudioProcessor::readState(const void* data, int sizeInBytes, String& activeServerStr) {
+    traceScope();
+    MemoryInputStream header(data, as<size_t>(sizeInBytes), false);
+    if (sizeInBytes < 12 || header.readInt() != STATE_MAGIC) {
+        return false;
+    }
+    int version = header.readInt();
+    int flags = header.readInt();
+    if (version > STATE_VERSION) {
+        logln("state version " << version << " is not supported");
+        return true;
+    }
+    std::unique_ptr<InputStream> body;
+    auto* bodyData = static_cast<const char*>(data) + header.getPosition();
+    auto bodySize = as<size_t>(sizeInBytes) - (size_t)header.getPosition();
+    if (flags & STATE_FLAG_COMPRESSED) {
+        body = std::make_unique<GZIPDecompressorInputStream>(new MemoryInputStream(bodyData, bodySize, false), true);
+    } else {
+        body = std::make_unique<MemoryInputStream>(bodyData, bodySize, false);
+    }
+    auto& in = *body;
+    auto readCount = [this, &in](const char* what) {
+        int count = in.readInt();
+        if (count < 0 || count > STATE_MAX_COUNT) {
+            logln("invalid state: " << count << " " << what);
+            return -1;
+        }
+        return count;
+    };
+    m_servers.clear();
+    int num = readCount("servers");
+    if (num < 0) {
+        return true;
+    }
+    for (int i = 0; i < num && !in.isExhausted(); i++) {
+        m_servers.add(in.readString());
+    }
+    activeServerStr = in.readString();
+    {
+        std::lock_guard<std::mutex> lock(m_busMtx);
+        m_sendBus = in.readString();
+        m_returnBus = in.readString();
+        m_sidechain.publish = in.readString();
+        m_sidechain.publishOutput = in.readBool();
+        m_sidechain.source = in.readString();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        m_loadedPlugins.clear();
+        num = readCount("plugins");
+        for (int i = 0; i < num && !in.isExhausted(); i++) {
+            LoadedPlugin plug;
+            plug.id = in.readString();
+            plug.name = in.readString();
+            in.readIntoMemoryBlock(plug.settings, jmax(0, in.readInt()));
+            int numPresets = readCount("presets");
+            if (numPresets < 0) {
+                break;
+            }
+            for (int p = 0; p < numPresets && !in.isExhausted(); p++) {
+                plug.presets.add(in.readString());
+            }
+            // decoded by getParams
+            in.readIntoMemoryBlock(plug.paramsData, jmax(0, in.readInt()));
+            plug.bypassed = in.readBool();
+            plug.parallelGroup = in.readInt();
+            plug.parallelBranch = in.readInt();
+            m_loadedPlugins.push_back(std::move(plug));
+        }
+        m_parallelDryGroups.clear();
+        if (!in.isExhausted()) {
+            num = readCount("parallel dry groups");
+            for (int i = 0; i < num && !in.isExhausted(); i++) {
+                m_parallelDryGroups.insert(in.readInt());
+            }
+        }
+    }
+    return true;
+}
+
+void AudioGridderAudioProcessor::readStateJson(const void* data, int sizeInBytes, String& activeServerStr,
+                                               int& activeServer) {
+    traceScope();
     std::string dump(static_cast<const char*>(data), as<size_t>(sizeInBytes));
+    auto fromBase64 = [](const json& j) {
+        MemoryBlock block;
+        block.fromBase64Encoding(j.get<std::string>());
+        return block;
+    };
     try {
         json j = json::parse(dump);
         int version = 0;
@@ -542,8 +759,14 @@ void AudioGridderAudioProcessor::setStateInformation(const void* data, int sizeI
                 m_servers.add(srv.get<std::string>());
             }
         }
-        String activeServerStr;
-        int activeServer = -1;
+        {
+            std::lock_guard<std::mutex> lock(m_busMtx);
+            m_sendBus = jsonGetValue(j, "sendBus", String());
+            m_returnBus = jsonGetValue(j, "returnBus", String());
+            m_sidechain.publish = jsonGetValue(j, "sidechainPublish", String());
+            m_sidechain.publishOutput = jsonGetValue(j, "sidechainPublishOutput", false);
+            m_sidechain.source = jsonGetValue(j, "sidechainSource", String());
+        }
         if (j.find("activeServerStr") != j.end()) {
             activeServerStr = j["activeServerStr"].get<std::string>();
         } else if (j.find("activeServer") != j.end()) {
@@ -552,19 +775,19 @@ void AudioGridderAudioProcessor::setStateInformation(const void* data, int sizeI
         {
             std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
             m_loadedPlugins.clear();
+            m_parallelDryGroups.clear();
             if (j.find("loadedPlugins") != j.end()) {
                 for (auto& plug : j["loadedPlugins"]) {
                     if (version < 1) {
                         StringArray dummy;
                         Array<Client::Parameter> dummy2;
                         m_loadedPlugins.push_back({plug[0].get<std::string>(), plug[1].get<std::string>(),
-                                                   plug[2].get<std::string>(), dummy, dummy2, false, false});
+                                                   fromBase64(plug[2]), dummy, dummy2, false, false});
                     } else if (version == 1) {
                         StringArray dummy;
                         Array<Client::Parameter> dummy2;
                         m_loadedPlugins.push_back({plug[0].get<std::string>(), plug[1].get<std::string>(),
-                                                   plug[2].get<std::string>(), dummy, dummy2, plug[3].get<bool>(),
-                                                   false});
+                                                   fromBase64(plug[2]), dummy, dummy2, plug[3].get<bool>(), false});
                     } else {
                         StringArray presets;
                         for (auto& p : plug[3]) {
@@ -574,20 +797,18 @@ void AudioGridderAudioProcessor::setStateInformation(const void* data, int sizeI
                         for (auto& p : plug[4]) {
                             params.add(e47::Client::Parameter::fromJson(p));
                         }
+                        int parallelGroup = 0, parallelBranch = 0;
+                        if (plug.size() > 7) {
+                            parallelGroup = plug[6].get<int>();
+                            parallelBranch = plug[7].get<int>();
+                        }
                         m_loadedPlugins.push_back({plug[0].get<std::string>(), plug[1].get<std::string>(),
-                                                   plug[2].get<std::string>(), presets, params, plug[5].get<bool>(),
-                                                   false});
+                                                   fromBase64(plug[2]), presets, params, plug[5].get<bool>(), false,
+                                                   parallelGroup, parallelBranch});
                     }
                 }
             }
         }
-        if (activeServerStr.isNotEmpty()) {
-            m_client->setServer(activeServerStr);
-            m_client->reconnect();
-        } else if (activeServer > -1 && activeServer < m_servers.size()) {
-            m_client->setServer(m_servers[activeServer]);
-            m_client->reconnect();
-        }
     } catch (json::parse_error& e) {
         logln("parsing state info failed: " << e.what());
     }
@@ -601,15 +822,24 @@ void AudioGridderAudioProcessor::sync() {
         for (int i = 0; i < (int)m_loadedPlugins.size(); i++) {
             auto& plug = m_loadedPlugins[(size_t)i];
             if (plug.ok && m_client->isReadyLockFree()) {
-                auto settings = m_client->getPluginSettings(static_cast<int>(i));
-                if (settings.getSize() > 0) {
-                    plug.settings = settings.toBase64Encoding();
-                }
+                syncPluginSettings(i, plug);
             }
         }
     }
 }
 
+void AudioGridderAudioProcessor::syncPluginSettings(int idx, LoadedPlugin& plug) {
+    traceScope();
+    if (plug.settingsHash.isEmpty()) {
+        plug.settingsHash = PluginSettingsHash::calculate(plug.settings);
+    }
+    auto settings = m_client->getPluginSettings(idx, plug.settingsHash, plug.settings);
+    if (settings.getSize() > 0) {
+        plug.settingsHash = PluginSettingsHash::calculate(settings);
+        plug.settings = std::move(settings);
+    }
+}
+
 std::vector<ServerPlugin> AudioGridderAudioProcessor::getPlugins(const String& type) const {
     traceScope();
     std::vector<ServerPlugin> ret;
@@ -646,7 +876,7 @@ bool AudioGridderAudioProcessor::loadPlugin(const String& id, const String& name
     if (success) {
         updateLatency(m_client->getLatencySamples());
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
-        m_loadedPlugins.push_back({id, name, "", presets, params, false, true});
+        m_loadedPlugins.push_back({id, name, {}, presets, params, false, true});
     }
     m_client->setLoadedPluginsString(getLoadedPluginsString());
     return success;
@@ -659,12 +889,17 @@ void AudioGridderAudioProcessor::unloadPlugin(int idx) {
         m_client->delPlugin(idx);
         suspendProcessing(false);
         updateLatency(m_client->getLatencySamples());
+        // the server drops the parameter subscription, when deleting a plugin
+        m_subscribedPlugin = -1;
     }
 
     if (idx == m_activePlugin) {
         hidePlugin();
     } else if (idx < m_activePlugin) {
         m_activePlugin--;
+        if (m_genericEditor) {
+            subscribeParameters(m_activePlugin);
+        }
     }
 
     {
@@ -702,9 +937,19 @@ void AudioGridderAudioProcessor::editPlugin(int idx) {
     if (!m_genericEditor && getLoadedPlugin(idx).ok) {
         m_client->editPlugin(idx);
     }
+    // the generic editor gets the parameter changes pushed by the server
+    subscribeParameters(m_genericEditor && getLoadedPlugin(idx).ok ? idx : -1);
     m_activePlugin = idx;
 }
 
+void AudioGridderAudioProcessor::subscribeParameters(int idx) {
+    traceScope();
+    if (idx != m_subscribedPlugin) {
+        m_client->subscribeParameters(idx);
+        m_subscribedPlugin = idx;
+    }
+}
+
 void AudioGridderAudioProcessor::hidePlugin(bool updateServer) {
     traceScope();
     if (m_activePlugin < 0) {
@@ -714,6 +959,7 @@ void AudioGridderAudioProcessor::hidePlugin(bool updateServer) {
                                           << (updateServer ? "updating server" : "not updating server"));
     if (updateServer) {
         m_client->hidePlugin();
+        subscribeParameters(-1);
     }
     m_activePlugin = -1;
 }
@@ -784,6 +1030,11 @@ void AudioGridderAudioProcessor::exchangePlugins(int idxA, int idxB) {
         } else if (idxB == m_activePlugin) {
             m_activePlugin = idxA;
         }
+        // the server drops the parameter subscription, when exchanging plugins
+        m_subscribedPlugin = -1;
+        if (m_genericEditor && m_activePlugin > -1) {
+            subscribeParameters(m_activePlugin);
+        }
         for (auto* p : getParameters()) {
             auto* param = dynamic_cast<Parameter*>(p);
             if (param->m_idx == idxA) {
@@ -797,13 +1048,94 @@ void AudioGridderAudioProcessor::exchangePlugins(int idxA, int idxB) {
     }
 }
 
+void AudioGridderAudioProcessor::setParallelBranch(int idx, int group, int branch) {
+    traceScope();
+    bool updateServer = false;
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        if (idx > -1 && idx < (int)m_loadedPlugins.size()) {
+            logln("moving plugin " << idx << " to parallel group " << group << ", branch " << branch);
+            m_loadedPlugins[(size_t)idx].parallelGroup = group;
+            m_loadedPlugins[(size_t)idx].parallelBranch = branch;
+            updateServer = m_loadedPlugins[(size_t)idx].ok;
+        } else {
+            logln("failed to set parallel branch for plugin " << idx << ": out of range");
+        }
+    }
+    if (updateServer) {
+        suspendProcessing(true);
+        m_client->setParallelBranch(idx, group, branch);
+        suspendProcessing(false);
+        updateLatency(m_client->getLatencySamples());
+    }
+}
+
+bool AudioGridderAudioProcessor::isParallelDry(int group) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+    return m_parallelDryGroups.count(group) > 0;
+}
+
+void AudioGridderAudioProcessor::setParallelDry(int group, bool dry) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        if (dry) {
+            m_parallelDryGroups.insert(group);
+        } else {
+            m_parallelDryGroups.erase(group);
+        }
+    }
+    suspendProcessing(true);
+    m_client->setParallelDry(group, dry);
+    suspendProcessing(false);
+    updateLatency(m_client->getLatencySamples());
+}
+
+String AudioGridderAudioProcessor::getSendBus() {
+    std::lock_guard<std::mutex> lock(m_busMtx);
+    return m_sendBus;
+}
+
+String AudioGridderAudioProcessor::getReturnBus() {
+    std::lock_guard<std::mutex> lock(m_busMtx);
+    return m_returnBus;
+}
+
+void AudioGridderAudioProcessor::setBus(const String& sendBus, const String& returnBus) {
+    traceScope();
+    logln("setting send bus to '" << sendBus << "' and return bus to '" << returnBus << "'");
+    {
+        std::lock_guard<std::mutex> lock(m_busMtx);
+        m_sendBus = sendBus;
+        m_returnBus = returnBus;
+    }
+    m_client->setBus(sendBus, returnBus);
+}
+
+AudioGridderAudioProcessor::SidechainConfig AudioGridderAudioProcessor::getSidechain() {
+    std::lock_guard<std::mutex> lock(m_busMtx);
+    return m_sidechain;
+}
+
+void AudioGridderAudioProcessor::setSidechain(const SidechainConfig& cfg) {
+    traceScope();
+    logln("setting sidechain: publish='" << cfg.publish << "' (" << (cfg.publishOutput ? "output" : "input")
+                                         << "), source='" << cfg.source << "'");
+    {
+        std::lock_guard<std::mutex> lock(m_busMtx);
+        m_sidechain = cfg;
+    }
+    m_client->setSidechain(cfg.publish, cfg.publishOutput, cfg.source);
+}
+
 bool AudioGridderAudioProcessor::enableParamAutomation(int idx, int paramIdx, int slot) {
     traceScope();
     logln("enabling automation for plugin " << idx << ", parameter " << paramIdx << ", slot " << slot);
     bool updateHost = false;
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
-        auto& param = m_loadedPlugins[(size_t)idx].params.getReference(paramIdx);
+        auto& param = m_loadedPlugins[(size_t)idx].getParams().getReference(paramIdx);
         Parameter* pparam = nullptr;
         if (slot == -1) {
             for (slot = 0; slot < m_numberOfAutomationSlots; slot++) {
@@ -836,7 +1168,7 @@ void AudioGridderAudioProcessor::disableParamAutomation(int idx, int paramIdx) {
     logln("disabling automation for plugin " << idx << ", parameter " << paramIdx);
     {
         std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
-        auto& param = m_loadedPlugins[(size_t)idx].params.getReference(paramIdx);
+        auto& param = m_loadedPlugins[(size_t)idx].getParams().getReference(paramIdx);
         auto* pparam = dynamic_cast<Parameter*>(getParameters()[param.automationSlot]);
         pparam->reset();
         param.automationSlot = -1;
@@ -848,7 +1180,7 @@ void AudioGridderAudioProcessor::getAllParameterValues(int idx) {
     traceScope();
     logln("reading all parameter values for plugin " << idx);
     std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
-    auto& params = m_loadedPlugins[(size_t)idx].params;
+    auto& params = m_loadedPlugins[(size_t)idx].getParams();
     for (auto& res : m_client->getAllParameterValues(idx, params.size())) {
         if (res.idx > -1 && res.idx < params.size()) {
             auto& param = params.getReference(res.idx);
@@ -861,6 +1193,29 @@ void AudioGridderAudioProcessor::getAllParameterValues(int idx) {
     }
 }
 
+void AudioGridderAudioProcessor::setParameterValues(int idx, const Array<Client::ParameterResult>& values) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+        if (idx < 0 || idx >= (int)m_loadedPlugins.size()) {
+            return;
+        }
+        auto& params = m_loadedPlugins[(size_t)idx].getParams();
+        for (auto& res : values) {
+            if (res.idx > -1 && res.idx < params.size() && params.getReference(res.idx).idx == res.idx) {
+                params.getReference(res.idx).currentValue = res.value;
+            }
+        }
+    }
+    runOnMsgThreadAsync([this, idx, values] {
+        traceScope();
+        auto* editor = getActiveEditor();
+        if (editor != nullptr) {
+            dynamic_cast<AudioGridderAudioProcessorEditor*>(editor)->setParameterValues(idx, values);
+        }
+    });
+}
+
 void AudioGridderAudioProcessor::delServer(const String& s) {
     traceScope();
     if (m_servers.contains(s)) {
@@ -894,9 +1249,11 @@ void AudioGridderAudioProcessor::storeSettingsA() {
     if (m_activePlugin < 0) {
         return;
     }
-    auto settings = m_client->getPluginSettings(m_activePlugin);
-    if (settings.getSize() > 0) {
-        m_settingsA = settings.toBase64Encoding();
+    std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+    if (m_activePlugin < (int)m_loadedPlugins.size()) {
+        auto& plug = m_loadedPlugins[(size_t)m_activePlugin];
+        syncPluginSettings(m_activePlugin, plug);
+        m_settingsA = plug.settings;
     }
 }
 
@@ -905,9 +1262,11 @@ void AudioGridderAudioProcessor::storeSettingsB() {
     if (m_activePlugin < 0) {
         return;
     }
-    auto settings = m_client->getPluginSettings(m_activePlugin);
-    if (settings.getSize() > 0) {
-        m_settingsB = settings.toBase64Encoding();
+    std::lock_guard<std::mutex> lock(m_loadedPluginsSyncMtx);
+    if (m_activePlugin < (int)m_loadedPlugins.size()) {
+        auto& plug = m_loadedPlugins[(size_t)m_activePlugin];
+        syncPluginSettings(m_activePlugin, plug);
+        m_settingsB = plug.settings;
     }
 }
 
@@ -916,7 +1275,8 @@ void AudioGridderAudioProcessor::restoreSettingsA() {
     if (m_activePlugin < 0) {
         return;
     }
-    m_client->setPluginSettings(m_activePlugin, m_settingsA);
+    auto& plug = getLoadedPlugin(m_activePlugin);
+    m_client->setPluginSettings(m_activePlugin, m_settingsA, plug.settingsHash, plug.settings);
 }
 
 void AudioGridderAudioProcessor::restoreSettingsB() {
@@ -924,13 +1284,14 @@ void AudioGridderAudioProcessor::restoreSettingsB() {
     if (m_activePlugin < 0) {
         return;
     }
-    m_client->setPluginSettings(m_activePlugin, m_settingsB);
+    auto& plug = getLoadedPlugin(m_activePlugin);
+    m_client->setPluginSettings(m_activePlugin, m_settingsB, plug.settingsHash, plug.settings);
 }
 
 void AudioGridderAudioProcessor::resetSettingsAB() {
     traceScope();
-    m_settingsA = "";
-    m_settingsB = "";
+    m_settingsA.reset();
+    m_settingsB.reset();
 }
 
 void AudioGridderAudioProcessor::setActiveServer(const ServerInfo& s) {
@@ -964,6 +1325,35 @@ void AudioGridderAudioProcessor::setCPULoad(float load) {
     });
 }
 
+void AudioGridderAudioProcessor::setPluginStats(const std::vector<Client::PluginDSPStats>& stats) {
+    traceScope();
+    runOnMsgThreadAsync([this, stats] {
+        traceScope();
+        auto* editor = getActiveEditor();
+        if (editor != nullptr) {
+            dynamic_cast<AudioGridderAudioProcessorEditor*>(editor)->setPluginStats(stats);
+        }
+    });
+}
+
+void AudioGridderAudioProcessor::setServerOverload(int level, const StringArray& events, const Array<int>& bypassed) {
+    traceScope();
+    StringArray recent;
+    {
+        std::lock_guard<std::mutex> lock(m_overloadEventsMtx);
+        m_overloadEvents.addArray(events);
+        m_overloadEvents.removeRange(0, m_overloadEvents.size() - 5);
+        recent = m_overloadEvents;
+    }
+    runOnMsgThreadAsync([this, level, recent, bypassed] {
+        traceScope();
+        auto* editor = getActiveEditor();
+        if (editor != nullptr) {
+            dynamic_cast<AudioGridderAudioProcessorEditor*>(editor)->setServerOverload(level, recent, bypassed);
+        }
+    });
+}
+
 float AudioGridderAudioProcessor::Parameter::getValue() const {
     traceScope();
     if (m_idx > -1 && m_paramIdx > -1) {
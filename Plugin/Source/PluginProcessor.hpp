@@ -76,6 +76,7 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     void loadConfig();
     void loadConfig(const json& j, bool isUpdate = false);
     void saveConfig(int numOfBuffers = -1);
+    void setNetworkFrameSize(int n);
 
     Client& getClient() { return *m_client; }
     std::vector<ServerPlugin> getPlugins(const String& type) const;
@@ -85,11 +86,37 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     struct LoadedPlugin {
         String id;
         String name;
-        String settings;
+        MemoryBlock settings;
         StringArray presets;
         Array<Client::Parameter> params;
         bool bypassed = false;
         bool ok = false;
+        int parallelGroup = 0;
+        int parallelBranch = 0;
+        // hash of the settings, the server compares it to the current settings to avoid unneeded transfers
+        String settingsHash;
+        // parameters read from a binary state, they get decoded on first access, as projects with many plugins
+        // would spend most of the load time on decoding parameters, that are never looked at
+        MemoryBlock paramsData;
+        // guards the decoding, copies of a plugin share it
+        std::shared_ptr<std::mutex> paramsMtx = std::make_shared<std::mutex>();
+
+        Array<Client::Parameter>& getParams() {
+            std::lock_guard<std::mutex> lock(*paramsMtx);
+            decodeParamsNoLock();
+            return params;
+        }
+
+        void decodeParamsNoLock() {
+            if (paramsData.getSize() > 0) {
+                MemoryInputStream in(paramsData, false);
+                int num = in.readInt();
+                for (int i = 0; i < num && !in.isExhausted(); i++) {
+                    params.add(Client::Parameter::read(in));
+                }
+                paramsData.reset();
+            }
+        }
     };
 
     // Called by the client object to trigger resyncing the remote plugin settings
@@ -119,9 +146,31 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     void bypassPlugin(int idx);
     void unbypassPlugin(int idx);
     void exchangePlugins(int idxA, int idxB);
+    void setParallelBranch(int idx, int group, int branch);
+    bool isParallelDry(int group);
+    void setParallelDry(int group, bool dry);
+
+    // Shared server buses: the output of this instance can be sent to a bus and/or the mix of a bus can be added to
+    // the input of this instance
+    String getSendBus();
+    String getReturnBus();
+    void setBus(const String& sendBus, const String& returnBus);
+
+    // Server side sidechain routing: the input or output of this instance can be published as a sidechain source
+    // and/or a sidechain source can be fed into the sidechain channels of this instance
+    struct SidechainConfig {
+        String publish;
+        bool publishOutput = false;
+        String source;
+    };
+    SidechainConfig getSidechain();
+    void setSidechain(const SidechainConfig& cfg);
+
     bool enableParamAutomation(int idx, int paramIdx, int slot = -1);
     void disableParamAutomation(int idx, int paramIdx);
     void getAllParameterValues(int idx);
+    // Called with the values pushed by the server for the subscribed plugin
+    void setParameterValues(int idx, const Array<Client::ParameterResult>& values);
     void increaseSCArea();
     void decreaseSCArea();
     void toggleFullscreenSCArea();
@@ -153,9 +202,11 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     void setActiveServer(const ServerInfo& s);
     Array<ServerInfo> getServersMDNS();
     void setCPULoad(float load);
+    void setPluginStats(const std::vector<Client::PluginDSPStats>& stats);
+    void setServerOverload(int level, const StringArray& events, const Array<int>& bypassed);
 
     int getLatencyMillis() const {
-        return as<int>(lround(m_client->NUM_OF_BUFFERS * getBlockSize() * 1000 / getSampleRate()));
+        return as<int>(lround(m_client->getBufferingLatencySamples() * 1000 / getSampleRate()));
     }
 
     // It looks like most hosts do not support dynamic parameter creation or changes to existing parameters. Logic
@@ -201,12 +252,22 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     };
 
   private:
+    // timing harness in Plugin/Tests
+    friend class PluginBenchmark;
+
     Uuid m_instId;
     std::unique_ptr<Client> m_client;
+    // the client and the logger, tracer, metrics, mDNS receiver etc. get set up with the first prepareToPlay or when
+    // the editor gets opened for the first time
+    std::atomic_bool m_clientStarted{false};
     std::atomic_bool m_prepared{false};
     std::vector<LoadedPlugin> m_loadedPlugins;
+    // parallel groups with a dry branch
+    std::set<int> m_parallelDryGroups;
     mutable std::mutex m_loadedPluginsSyncMtx;
     int m_activePlugin = -1;
+    // the plugin, whose parameter changes are pushed by the server for the generic editor
+    std::atomic_int m_subscribedPlugin{-1};
     StringArray m_servers;
     String m_activeServerFromCfg;
     int m_activeServerLegacyFromCfg;
@@ -219,7 +280,7 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
     Array<Array<double>> m_bypassBufferD;
     std::mutex m_bypassBufferMtx;
 
-    String m_settingsA, m_settingsB;
+    MemoryBlock m_settingsA, m_settingsB;
 
     bool m_menuShowCategory = true;
     bool m_menuShowCompany = true;
@@ -233,6 +294,35 @@ class AudioGridderAudioProcessor : public AudioProcessor, public LogTagDelegate
 
     SyncRemoteMode m_syncRemote = SYNC_WITH_EDITOR;
 
+    String m_sendBus, m_returnBus;
+    SidechainConfig m_sidechain;
+    std::mutex m_busMtx;
+
+    // the recent actions of the overload protection of the server
+    StringArray m_overloadEvents;
+    std::mutex m_overloadEventsMtx;
+
+    // Fetches the settings of a loaded plugin from the server, if they have changed
+    void syncPluginSettings(int idx, LoadedPlugin& plug);
+
+    void subscribeParameters(int idx);
+
+    // Sets up everything, that is not needed to restore the state, and starts the client. Called once.
+    void startClient();
+
+    // Binary state format: magic, version, flags and the (optionally compressed) body
+    static constexpr int STATE_MAGIC = 0x53424741;  // "AGBS"
+    static constexpr int STATE_VERSION = 1;
+    static constexpr int STATE_FLAG_COMPRESSED = 1;
+    // The body gets compressed, if it is larger than this
+    static constexpr size_t STATE_COMPRESS_MIN_SIZE = 64 * 1024;
+    // Counts in a state above this are treated as corrupted
+    static constexpr int STATE_MAX_COUNT = 64 * 1024;
+
+    void writeState(MemoryBlock& destData);
+    bool readState(const void* data, int sizeInBytes, String& activeServerStr);
+    void readStateJson(const void* data, int sizeInBytes, String& activeServerStr, int& activeServer);
+
     ENABLE_ASYNC_FUNCTORS();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioGridderAudioProcessor)
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+/*
+ * Timing harness for the plugin. Measures the construction cost of plugin instances, as hosts create hundreds of them
+ * when opening big projects. Serializes a synthetic multi plugin state in the binary format and in the old JSON format
+ * and reports sizes and durations.
+ *
+ * Usage: AGPluginBenchmark [plugins] [parameters per plugin] [repetitions] [instances]
+ */
+
+#include <JuceHeader.h>
+
+#include "PluginProcessor.hpp"
+
+namespace e47 {
+
+class PluginBenchmark {
+  public:
+    PluginBenchmark(AudioGridderAudioProcessor& proc) : m_proc(proc) {}
+
+    static bool runStartup(int numInstances) {
+        std::vector<std::unique_ptr<AudioGridderAudioProcessor>> procs;
+        std::vector<double> times;
+        TimeStatistic::Duration duration;
+        for (int i = 0; i < numInstances; i++) {
+            procs.push_back(std::make_unique<AudioGridderAudioProcessor>());
+            times.push_back(duration.update());
+        }
+        double total = 0, max = 0;
+        for (auto t : times) {
+            total += t;
+            max = jmax(max, t);
+        }
+        // the first instance sets up the process wide parts
+        double first = times.front();
+        double avg = times.size() > 1 ? (total - first) / (double)(times.size() - 1) : first;
+        procs.clear();
+        double destroy = duration.update() / numInstances;
+
+        std::cout << "startup of " << numInstances << " instances" << std::endl;
+        std::cout << "  construct: first " << String(first, 3) << " ms, avg " << String(avg, 3) << " ms, max "
+                  << String(max, 3) << " ms, total " << String(total, 3) << " ms" << std::endl;
+        std::cout << "  destruct:  avg " << String(destroy, 3) << " ms" << std::endl;
+        return true;
+    }
+
+    void createState(int numPlugins, int numParams) {
+        Random rnd(47);
+        std::lock_guard<std::mutex> lock(m_proc.m_loadedPluginsSyncMtx);
+        m_proc.m_loadedPlugins.clear();
+        for (int i = 0; i < numPlugins; i++) {
+            AudioGridderAudioProcessor::LoadedPlugin plug;
+            plug.id = "VST3-Synthetic" + String(i) + "-" + String::toHexString(rnd.nextInt());
+            plug.name = "Synthetic " + String(i);
+            // plugin settings are mostly opaque binary blobs
+            plug.settings.setSize((size_t)rnd.nextInt({4096, 65536}));
+            rnd.fillBitsRandomly(plug.settings.getData(), plug.settings.getSize());
+            for (int p = 0; p < 20; p++) {
+                plug.presets.add("Preset " + String(p));
+            }
+            for (int p = 0; p < numParams; p++) {
+                Client::Parameter param;
+                param.idx = p;
+                param.name = "Parameter " + String(p);
+                param.defaultValue = rnd.nextFloat();
+                param.currentValue = rnd.nextFloat();
+                param.label = "dB";
+                if (p % 10 == 0) {
+                    param.allValues.addArray({"Off", "Low", "Mid", "High"});
+                }
+                plug.params.add(param);
+            }
+            plug.bypassed = i % 4 == 0;
+            plug.parallelGroup = i % 3;
+            plug.parallelBranch = i % 2;
+            m_proc.m_loadedPlugins.push_back(std::move(plug));
+        }
+        // the reference for the round trips
+        m_expected = m_proc.m_loadedPlugins;
+    }
+
+    bool runState(int reps) {
+        size_t numPlugins = m_expected.size(), numParams = 0;
+        for (auto& plug : m_expected) {
+            numParams += (size_t)plug.params.size();
+        }
+
+        MemoryBlock bin;
+        TimeStatistic::Duration duration;
+        for (int i = 0; i < reps; i++) {
+            bin.reset();
+            m_proc.writeState(bin);
+        }
+        double binWrite = duration.update() / reps;
+        String activeServerStr;
+        for (int i = 0; i < reps; i++) {
+            m_proc.readState(bin.getData(), (int)bin.getSize(), activeServerStr);
+        }
+        double binRead = duration.update() / reps;
+        // the parameters are decoded on first access, which is measured separately
+        double binDecode = decodeParams();
+        if (!verify("binary")) {
+            return false;
+        }
+
+        std::string dump;
+        duration.reset();
+        for (int i = 0; i < reps; i++) {
+            dump = getJsonState().dump();
+        }
+        double jsonWrite = duration.update() / reps;
+        int activeServer = -1;
+        for (int i = 0; i < reps; i++) {
+            m_proc.readStateJson(dump.data(), (int)dump.length(), activeServerStr, activeServer);
+        }
+        double jsonRead = duration.update() / reps;
+        if (!verify("JSON")) {
+            return false;
+        }
+
+        std::cout << "state of " << numPlugins << " plugins with " << numParams << " parameters, " << reps
+                  << " repetitions" << std::endl;
+        std::cout << "  binary: " << bin.getSize() << " bytes, write " << String(binWrite, 3) << " ms, read "
+                  << String(binRead, 3) << " ms, decode parameters " << String(binDecode, 3) << " ms" << std::endl;
+        std::cout << "  json:   " << dump.length() << " bytes, write " << String(jsonWrite, 3) << " ms, read "
+                  << String(jsonRead, 3) << " ms" << std::endl;
+        return true;
+    }
+
+  private:
+    AudioGridderAudioProcessor& m_proc;
+    std::vector<AudioGridderAudioProcessor::LoadedPlugin> m_expected;
+
+    double decodeParams() {
+        TimeStatistic::Duration duration;
+        std::lock_guard<std::mutex> lock(m_proc.m_loadedPluginsSyncMtx);
+        for (auto& plug : m_proc.m_loadedPlugins) {
+            plug.getParams();
+        }
+        return duration.update();
+    }
+
+    bool fail(const String& format, size_t plugin, const String& what) {
+        std::cerr << "FAILED: " << format << " state round trip, plugin " << plugin << ": " << what << std::endl;
+        return false;
+    }
+
+    // Compares the restored plugins with the written ones
+    bool verify(const String& format) {
+        std::lock_guard<std::mutex> lock(m_proc.m_loadedPluginsSyncMtx);
+        auto& plugs = m_proc.m_loadedPlugins;
+        if (plugs.size() != m_expected.size()) {
+            std::cerr << "FAILED: " << format << " state round trip: " << plugs.size() << " plugins, expected "
+                      << m_expected.size() << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < plugs.size(); i++) {
+            auto& plug = plugs[i];
+            auto& exp = m_expected[i];
+            if (plug.id != exp.id || plug.name != exp.name) {
+                return fail(format, i, "id or name");
+            }
+            if (plug.settings != exp.settings) {
+                return fail(format, i, "settings");
+            }
+            if (plug.presets != exp.presets) {
+                return fail(format, i, "presets");
+            }
+            if (plug.bypassed != exp.bypassed || plug.parallelGroup != exp.parallelGroup ||
+                plug.parallelBranch != exp.parallelBranch) {
+                return fail(format, i, "bypass or parallel fields");
+            }
+            auto& params = plug.getParams();
+            if (params.size() != exp.params.size()) {
+                return fail(format, i, "number of parameters");
+            }
+            for (int p = 0; p < params.size(); p++) {
+                auto& param = params.getReference(p);
+                auto& expParam = exp.params.getReference(p);
+                if (param.idx != expParam.idx || param.name != expParam.name ||
+                    std::abs(param.currentValue - expParam.currentValue) > 1e-6f ||
+                    std::abs(param.defaultValue - expParam.defaultValue) > 1e-6f) {
+                    return fail(format, i, "parameter " + String(p));
+                }
+            }
+        }
+        return true;
+    }
+
+    // The format, that has been stored before the binary state was introduced
+    json getJsonState() {
+        json j;
+        j["version"] = 2;
+        j["servers"] = json::array();
+        j["activeServerStr"] = "";
+        auto jplugs = json::array();
+        std::lock_guard<std::mutex> lock(m_proc.m_loadedPluginsSyncMtx);
+        for (auto& plug : m_proc.m_loadedPlugins) {
+            auto jpresets = json::array();
+            for (auto& p : plug.presets) {
+                jpresets.push_back(p.toStdString());
+            }
+            auto jparams = json::array();
+            for (auto& p : plug.getParams()) {
+                jparams.push_back(p.toJson());
+            }
+            jplugs.push_back({plug.id.toStdString(), plug.name.toStdString(),
+                              plug.settings.toBase64Encoding().toStdString(), jpresets, jparams, plug.bypassed,
+                              plug.parallelGroup, plug.parallelBranch});
+        }
+        j["loadedPlugins"] = jplugs;
+        return j;
+    }
+};
+
+}  // namespace e47
+
+int main(int argc, char* argv[]) {
+    using namespace e47;
+    int numPlugins = argc > 1 ? String(argv[1]).getIntValue() : 50;
+    int numParams = argc > 2 ? String(argv[2]).getIntValue() : 500;
+    int reps = argc > 3 ? String(argv[3]).getIntValue() : 10;
+    int numInstances = argc > 4 ? String(argv[4]).getIntValue() : 200;
+
+    ScopedJuceInitialiser_GUI juceInit;
+    int ret = 0;
+    if (!PluginBenchmark::runStartup(jmax(1, numInstances))) {
+        ret = 1;
+    }
+    {
+        AudioGridderAudioProcessor proc;
+        PluginBenchmark bench(proc);
+        bench.createState(numPlugins, numParams);
+        if (!bench.runState(jmax(1, reps))) {
+            ret = 1;
+        }
+    }
+    return ret;
+}
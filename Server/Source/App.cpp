@@ -21,14 +21,21 @@ namespace e47 {
 
 void App::initialise(const String& commandLineParameters) {
     auto args = getCommandLineParameterArray();
-    enum Modes { SCAN, MASTER, SERVER };
+    enum Modes { SCAN, MASTER, SERVER, SANDBOX };
     Modes mode = MASTER;
     String fileToScan = "";
     int srvid = -1;
+    int sandboxPort = 0;
+    String sandboxClientHost;
     for (int i = 0; i < args.size(); i++) {
         if (!args[i].compare("-scan") && args.size() >= i + 2) {
             fileToScan = args[i + 1];
             mode = SCAN;
+        } else if (!args[i].compare("-sandbox") && args.size() >= i + 2) {
+            sandboxPort = args[i + 1].getIntValue();
+            mode = SANDBOX;
+        } else if (!args[i].compare("-clienthost") && args.size() >= i + 2) {
+            sandboxClientHost = args[i + 1];
         } else if (!args[i].compare("-server")) {
             mode = SERVER;
         } else if (!args[i].compare("-id")) {
@@ -49,6 +56,10 @@ void App::initialise(const String& commandLineParameters) {
         case SERVER:
             appName = "Server";
             break;
+        case SANDBOX:
+            appName = "Sandbox";
+            logName = getApplicationName() + "_Sandbox_" + String(sandboxPort) + "_";
+            break;
     }
     AGLogger::initialize(appName, logName, Defaults::getConfigFileName(Defaults::ConfigServer));
     Tracer::initialize(appName, logName);
@@ -101,6 +112,23 @@ void App::initialise(const String& commandLineParameters) {
             m_server->startThread();
             break;
         }
+        case SANDBOX: {
+            traceScope();
+#ifdef JUCE_MAC
+            Process::setDockIconVisible(false);
+#endif
+            CoreDump::initialize(appName, logName, false);
+            json opts;
+            if (srvid > -1) {
+                opts["ID"] = srvid;
+            }
+            opts["SandboxPort"] = sandboxPort;
+            opts["SandboxClientHost"] = sandboxClientHost.toStdString();
+            m_server = std::make_shared<Server>(opts);
+            m_server->initialize();
+            m_server->startThread();
+            break;
+        }
         case MASTER:
 #ifdef JUCE_MAC
             Process::setDockIconVisible(false);
@@ -11,6 +11,12 @@
 #include "Defaults.hpp"
 #include "App.hpp"
 #include "Metrics.hpp"
+#include "PluginPool.hpp"
+#include "DeadlineScheduler.hpp"
+#include "SharedBus.hpp"
+#include "SidechainSource.hpp"
+#include "OverloadGovernor.hpp"
+#include "MemoryInfo.hpp"
 
 namespace e47 {
 
@@ -35,11 +41,13 @@ AudioWorker::~AudioWorker() {
 }
 
 void AudioWorker::init(std::unique_ptr<StreamingSocket> s, int channelsIn, int channelsOut, double rate,
-                       int samplesPerBlock, bool doublePrecission) {
+                       int samplesPerBlock, bool doublePrecission, bool silentChannels) {
     traceScope();
     m_socket = std::move(s);
+    m_silentChannels = silentChannels;
     m_rate = rate;
     m_samplesPerBlock = samplesPerBlock;
+    m_procBlockSize = jmax(samplesPerBlock, getApp()->getServer().getInternalBlockSize());
     m_doublePrecission = doublePrecission;
     m_channelsIn = channelsIn;
     m_channelsOut = channelsOut;
@@ -49,6 +57,14 @@ void AudioWorker::init(std::unique_ptr<StreamingSocket> s, int channelsIn, int c
         m_chain->setProcessingPrecision(AudioProcessor::doublePrecision);
     }
     m_chain->updateChannels(channelsIn, channelsOut);
+    int channels = jmax(channelsIn, channelsOut);
+    m_blockAdapterF.prepare(channels, m_samplesPerBlock, m_procBlockSize);
+    m_blockAdapterD.prepare(channels, m_samplesPerBlock, m_procBlockSize);
+    if (m_procBlockSize != m_samplesPerBlock) {
+        logln("processing in blocks of " << m_procBlockSize << " samples (client block size is " << m_samplesPerBlock
+                                         << "), additional latency is " << m_blockAdapterF.getLatencySamples()
+                                         << " samples");
+    }
 }
 
 void AudioWorker::run() {
@@ -59,14 +75,42 @@ void AudioWorker::run() {
     AudioBuffer<float> bufferF;
     AudioBuffer<double> bufferD;
     MidiBuffer midi;
-    AudioMessage msg(getLogTagSource());
+    AudioMessage msg(getLogTagSource(), m_silentChannels);
     AudioPlayHead::CurrentPositionInfo posInfo;
     auto duration = TimeStatistic::getDuration("audio");
     auto bytesIn = Metrics::getStatistic<Meter>("NetBytesIn");
     auto bytesOut = Metrics::getStatistic<Meter>("NetBytesOut");
+    auto deadlineMisses = Metrics::getStatistic<Meter>("DeadlineMiss");
+    // track misses per client and audio configuration to see what the server can sustain
+    String clientCfg;
+    clientCfg << getExtra() << "|" << lround(m_rate) << "/" << m_samplesPerBlock;
+    auto clientDeadlineMisses = Metrics::getStatistic<Meter>("DeadlineMiss|" + clientCfg);
+    std::shared_ptr<DeadlineScheduler> scheduler;
+    if (getApp()->getServer().getEDFScheduling()) {
+        scheduler = DeadlineScheduler::getInstance();
+    }
+    auto blockTicks = Time::secondsToHighResolutionTicks(m_samplesPerBlock / m_rate);
+    auto silenceSkips = Metrics::getStatistic<Meter>("SilenceSkip");
+    bool skipSilence = getApp()->getServer().getSkipSilence();
+    // samples since the last block with input or output signal
+    int64 silentSamples = 0;
+    bool lastResponseSilent = false;
+    // samples since the transport has been stopped and the chain became silent
+    int64 idleSamples = 0;
+    int hibernateAfter = getApp()->getServer().getHibernateAfterSec();
+    bool hibernateUnload = getApp()->getServer().getHibernateUnload();
+    // a return waits up to half a block for the sends of its bus
+    int busTimeoutMs = jmax(1, (int)lround(500.0 * m_samplesPerBlock / m_rate));
+    // the last block read from the sidechain source
+    std::shared_ptr<SidechainSource> scLastSource;
+    uint64 scLastSeq = 0;
 
     ProcessorChain::PlayHead playHead(&posInfo);
-    m_chain->prepareToPlay(m_rate, m_samplesPerBlock);
+    m_chain->prepareToPlay(m_rate, m_procBlockSize);
+    auto governor = OverloadGovernor::getInstance();
+    if (nullptr != governor) {
+        governor->addChain(m_chain);
+    }
     bool hasToSetPlayHead = true;
 
     MessageHelper::Error e;
@@ -76,6 +120,7 @@ void AudioWorker::run() {
             if (msg.readFromClient(m_socket.get(), bufferF, bufferD, midi, posInfo, m_chain->getExtraChannels(), &e,
                                    *bytesIn)) {
                 duration.reset();
+                auto deadline = Time::getHighResolutionTicks() + blockTicks;
                 if (hasToSetPlayHead) {  // do not set the playhead before it's initialized
                     m_chain->setPlayHead(&playHead);
                     hasToSetPlayHead = false;
@@ -88,26 +133,116 @@ void AudioWorker::run() {
                     m_socket->close();
                     break;
                 }
-                bool sendOk;
-                if (msg.isDouble()) {
-                    if (m_chain->supportsDoublePrecisionProcessing()) {
-                        m_chain->processBlock(bufferD, midi);
+                std::shared_ptr<SharedBus> sendBus, returnBus;
+                std::shared_ptr<SidechainSource> scPublish, scSource;
+                bool scPublishOutput;
+                {
+                    std::lock_guard<std::mutex> lock(m_busMtx);
+                    sendBus = m_sendBus;
+                    returnBus = m_returnBus;
+                    scPublish = m_scPublish;
+                    scPublishOutput = m_scPublishOutput;
+                    scSource = m_scSource;
+                }
+                int64 position = posInfo.isPlaying ? posInfo.timeInSamples : -1;
+                if (nullptr != scPublish && !scPublishOutput) {
+                    if (msg.isDouble()) {
+                        scPublish->publish(bufferD, m_channelsIn, position);
                     } else {
-                        bufferF.makeCopyOf(bufferD);
-                        m_chain->processBlock(bufferF, midi);
-                        bufferD.makeCopyOf(bufferF);
+                        scPublish->publish(bufferF, m_channelsIn, position);
                     }
-                    sendOk = msg.sendToClient(m_socket.get(), bufferD, midi, m_chain->getLatencySamples(),
-                                              m_channelsOut, &e, *bytesOut);
+                }
+                bool inputSilent = msg.isSilent();
+                if (nullptr != returnBus) {
+                    bool busSignal = msg.isDouble() ? returnBus->receive(bufferD, busTimeoutMs)
+                                                    : returnBus->receive(bufferF, busTimeoutMs);
+                    inputSilent = inputSilent && !busSignal;
+                }
+                if (scSource != scLastSource) {
+                    scLastSource = scSource;
+                    scLastSeq = 0;
+                }
+                if (nullptr != scSource) {
+                    // the sidechain goes into the channels following the channels of the client
+                    bool scSignal = msg.isDouble()
+                                        ? scSource->read(bufferD, m_channelsIn, position, busTimeoutMs, scLastSeq)
+                                        : scSource->read(bufferF, m_channelsIn, position, busTimeoutMs, scLastSeq);
+                    inputSilent = inputSilent && !scSignal;
+                }
+                // Once the input and the output have been silent for longer than the tail and the latency of the chain,
+                // processing would only produce silence. The buffer is silent already, so we can just send it back.
+                bool skip = false;
+                int numSamples = jmax(msg.getSamples(), msg.getSamplesRequested());
+                if (skipSilence && lastResponseSilent && inputSilent) {
+                    silentSamples += numSamples;
+                    skip = silentSamples > m_chain->getTailLengthSeconds() * m_rate + getLatencySamples();
                 } else {
-                    m_chain->processBlock(bufferF, midi);
-                    sendOk = msg.sendToClient(m_socket.get(), bufferF, midi, m_chain->getLatencySamples(),
-                                              m_channelsOut, &e, *bytesOut);
+                    silentSamples = 0;
+                }
+                // Hibernate the chain after the transport has been stopped and the chain has been silent for a while.
+                // The first block with signal or a transport start resumes the chain.
+                bool idle = !posInfo.isPlaying && lastResponseSilent && inputSilent;
+                if (idle && !m_wakeUp.exchange(false)) {
+                    idleSamples += numSamples;
+                } else {
+                    idleSamples = 0;
+                }
+                if (m_chain->isHibernated()) {
+                    if (!idle) {
+                        // reloading plugins can take long, the chain resumes in the background and the client gets
+                        // silence until it is ready
+                        m_chain->resumeAsync();
+                    }
+                } else if (hibernateAfter > 0 && idleSamples > hibernateAfter * m_rate) {
+                    m_chain->hibernate(hibernateUnload);
+                }
+                if (skip || m_chain->isHibernated()) {
+                    silenceSkips->increment();
+                } else {
+                    DeadlineScheduler::ScopedSlot slot(scheduler, deadline);
+                    if (msg.isDouble()) {
+                        if (m_chain->supportsDoublePrecisionProcessing()) {
+                            processBlock(bufferD, midi, m_blockAdapterD);
+                        } else {
+                            bufferF.makeCopyOf(bufferD);
+                            processBlock(bufferF, midi, m_blockAdapterF);
+                            bufferD.makeCopyOf(bufferF);
+                        }
+                    } else {
+                        processBlock(bufferF, midi, m_blockAdapterF);
+                    }
+                }
+                if (nullptr != sendBus) {
+                    if (msg.isDouble()) {
+                        sendBus->send(this, bufferD, m_channelsOut);
+                    } else {
+                        sendBus->send(this, bufferF, m_channelsOut);
+                    }
+                }
+                if (nullptr != scPublish && scPublishOutput) {
+                    if (msg.isDouble()) {
+                        scPublish->publish(bufferD, m_channelsOut, position);
+                    } else {
+                        scPublish->publish(bufferF, m_channelsOut, position);
+                    }
+                }
+                bool sendOk;
+                if (msg.isDouble()) {
+                    sendOk = msg.sendToClient(m_socket.get(), bufferD, midi, getLatencySamples(), m_channelsOut, &e,
+                                              *bytesOut);
+                } else {
+                    sendOk = msg.sendToClient(m_socket.get(), bufferF, midi, getLatencySamples(), m_channelsOut, &e,
+                                              *bytesOut);
                 }
                 if (!sendOk) {
                     logln("error: failed to send audio data to client: " << e.toString());
                     m_socket->close();
                 }
+                lastResponseSilent = msg.isResponseSilent();
+                if (Time::getHighResolutionTicks() > deadline) {
+                    deadlineMisses->increment();
+                    clientDeadlineMisses->increment();
+                }
                 duration.update();
             } else {
                 logln("error: failed to read audio message: " << e.toString());
@@ -117,6 +252,14 @@ void AudioWorker::run() {
     }
 
     m_chain->setPlayHead(nullptr);
+    if (nullptr != governor) {
+        governor->removeChain(m_chain);
+    }
+    setBus("", "");
+    setSidechain("", false, "");
+
+    clientDeadlineMisses.reset();
+    Metrics::removeStatistic("DeadlineMiss|" + clientCfg);
 
     duration.clear();
     clear();
@@ -125,6 +268,72 @@ void AudioWorker::run() {
     runCount--;
 }
 
+void AudioWorker::setBus(const String& sendBus, const String& returnBus) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_busMtx);
+    if (nullptr != m_sendBus) {
+        m_sendBus->removeSend(this);
+        m_sendBus.reset();
+    }
+    if (nullptr != m_returnBus) {
+        m_returnBus->removeReturn(this);
+        m_returnBus.reset();
+    }
+    if (returnBus.isNotEmpty()) {
+        auto bus = SharedBus::getBus(returnBus);
+        if (bus->addReturn(this)) {
+            logln("returning from bus " << returnBus);
+            m_returnBus = bus;
+        } else {
+            logln("error: can't return from the bus " << returnBus << ", as it has a return already");
+        }
+    }
+    if (sendBus.isNotEmpty()) {
+        if (sendBus == returnBus) {
+            logln("error: can't send to the bus " << sendBus << ", as it is the return bus");
+        } else {
+            logln("sending to bus " << sendBus);
+            m_sendBus = SharedBus::getBus(sendBus);
+            m_sendBus->addSend(this, m_channelsOut, m_samplesPerBlock);
+        }
+    }
+}
+
+void AudioWorker::setSidechain(const String& publish, bool publishOutput, const String& source) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_busMtx);
+    if (nullptr != m_scPublish) {
+        m_scPublish->removePublisher();
+        m_scPublish.reset();
+    }
+    m_scSource.reset();
+    if (source.isNotEmpty()) {
+        logln("reading sidechain from " << source);
+        m_scSource = SidechainSource::getSource(source);
+    }
+    if (publish.isNotEmpty()) {
+        if (publish == source) {
+            logln("error: can't publish to the sidechain source " << publish << ", as it is the sidechain input");
+        } else {
+            logln("publishing " << (publishOutput ? "output" : "input") << " as sidechain " << publish);
+            m_scPublish = SidechainSource::getSource(publish);
+            m_scPublish->addPublisher();
+            m_scPublishOutput = publishOutput;
+        }
+    }
+}
+
+void AudioWorker::wakeUp() {
+    traceScope();
+    m_wakeUp = true;
+    // called by the command thread, the following command needs the plugins, so wait for them
+    if (m_chain->isHibernated()) {
+        auto resumeTime = TimeStatistic::getDuration("HibernationResume");
+        m_chain->resume();
+        resumeTime.update();
+    }
+}
+
 void AudioWorker::shutdown() {
     traceScope();
     signalThreadShouldExit();
@@ -139,9 +348,62 @@ void AudioWorker::clear() {
 
 bool AudioWorker::addPlugin(const String& id, String& err) {
     traceScope();
+    if (!checkMemoryBudget(id, 0, err)) {
+        return false;
+    }
     return m_chain->addPluginProcessor(id, err);
 }
 
+void AudioWorker::loadPlugins(const StringArray& ids, ProcessorChain::LoadedFn onLoaded) {
+    traceScope();
+    StringArray idsToLoad;
+    int64 reserved = 0;
+    for (int i = 0; i < ids.size(); i++) {
+        // the plugins load at the same time, so the budget has to cover all of them
+        String err;
+        if (ids[i].isEmpty()) {
+            idsToLoad.add({});
+            onLoaded((size_t)i, nullptr, "invalid plugin ID");
+        } else if (checkMemoryBudget(ids[i], reserved, err)) {
+            reserved += AGProcessor::getExpectedMemory(ids[i]);
+            idsToLoad.add(ids[i]);
+        } else {
+            idsToLoad.add({});
+            onLoaded((size_t)i, nullptr, err);
+        }
+    }
+    m_chain->loadPluginProcessors(idsToLoad, onLoaded);
+}
+
+void AudioWorker::addProcessors(const std::vector<std::shared_ptr<AGProcessor>>& procs) {
+    traceScope();
+    for (auto& proc : procs) {
+        if (nullptr != proc) {
+            m_chain->addProcessor(proc);
+        }
+    }
+}
+
+bool AudioWorker::checkMemoryBudget(const String& id, int64 reserved, String& err) {
+    traceScope();
+    int budgetMB = getApp()->getServer().getMemoryBudgetMB();
+    if (budgetMB > 0) {
+        auto used = MemoryInfo::getResidentBytes() + reserved;
+        auto expected = AGProcessor::getExpectedMemory(id);
+        if (used + expected > (int64)budgetMB * 1024 * 1024) {
+            err << "The memory budget of the server (" << budgetMB << " MB) is exhausted: "
+                << MemoryInfo::toMBString(used) << " in use";
+            if (expected > 0) {
+                err << ", the plugin needs about " << MemoryInfo::toMBString(expected);
+            }
+            err << ".";
+            logln("error: " << err);
+            return false;
+        }
+    }
+    return true;
+}
+
 void AudioWorker::delPlugin(int idx) {
     traceScope();
     logln("deleting plugin " << idx);
@@ -154,6 +416,16 @@ void AudioWorker::exchangePlugins(int idxA, int idxB) {
     m_chain->exchangeProcessors(idxA, idxB);
 }
 
+void AudioWorker::setParallelBranch(int idx, int group, int branch) {
+    traceScope();
+    m_chain->setParallelBranch(idx, group, branch);
+}
+
+void AudioWorker::setParallelDry(int group, bool dry) {
+    traceScope();
+    m_chain->setParallelDry(group, dry);
+}
+
 String AudioWorker::getRecentsList(String host) const {
     traceScope();
     std::lock_guard<std::mutex> lock(m_recentsMtx);
@@ -183,4 +455,25 @@ void AudioWorker::addToRecentsList(const String& id, const String& host) {
     }
 }
 
+void AudioWorker::seedPluginPool(const String& host) {
+    traceScope();
+    auto pool = PluginPool::getInstance();
+    if (nullptr == pool) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_recentsMtx);
+    PluginPool::Format fmt;
+    fmt.sampleRate = m_rate;
+    fmt.blockSize = m_procBlockSize;
+    fmt.channelsIn = m_channelsIn;
+    fmt.channelsOut = m_channelsOut;
+    fmt.doublePrecision = m_doublePrecission;
+    auto it = m_recents.find(host);
+    if (it != m_recents.end()) {
+        for (auto& r : it->second) {
+            pool->seed(AGProcessor::createPluginID(r), fmt);
+        }
+    }
+}
+
 }  // namespace e47
@@ -13,6 +13,7 @@
 #include <unordered_map>
 
 #include "ProcessorChain.hpp"
+#include "BlockAdapter.hpp"
 #include "Message.hpp"
 #include "Utils.hpp"
 
@@ -25,6 +26,8 @@ struct audio_chunk_hdr_t {
 };
 
 class ProcessorChain;
+class SharedBus;
+class SidechainSource;
 
 class AudioWorker : public Thread, public LogTagDelegate {
   public:
@@ -35,7 +38,7 @@ class AudioWorker : public Thread, public LogTagDelegate {
     virtual ~AudioWorker() override;
 
     void init(std::unique_ptr<StreamingSocket> s, int channelsIn, int channelsOut, double rate, int samplesPerBlock,
-              bool doublePrecission);
+              bool doublePrecission, bool silentChannels);
 
     void run() override;
     void shutdown();
@@ -45,15 +48,33 @@ class AudioWorker : public Thread, public LogTagDelegate {
     int getChannelsOut() const { return m_channelsOut; }
 
     bool addPlugin(const String& id, String& err);
+
+    // Loads the given plugins concurrently and returns right away. onLoaded gets called for every plugin as soon as
+    // its load has finished, plugins, that exceed the memory budget, fail right away.
+    void loadPlugins(const StringArray& ids, ProcessorChain::LoadedFn onLoaded);
+    // Adds the loaded processors in the given order, nullptr entries are skipped
+    void addProcessors(const std::vector<std::shared_ptr<AGProcessor>>& procs);
     void delPlugin(int idx);
     void exchangePlugins(int idxA, int idxB);
+    void setParallelBranch(int idx, int group, int branch);
+    void setParallelDry(int group, bool dry);
     std::shared_ptr<AGProcessor> getProcessor(int idx) const { return m_chain->getProcessor(idx); }
     int getSize() const { return static_cast<int>(m_chain->getSize()); }
-    int getLatencySamples() const { return m_chain->getLatencySamples(); }
+    int getLatencySamples() const { return m_chain->getLatencySamples() + m_blockAdapterF.getLatencySamples(); }
     void update() { m_chain->update(); }
 
     float getParameterValue(int idx, int paramIdx) { return m_chain->getParameterValue(idx, paramIdx); }
 
+    // Connects the worker to the given shared buses, an empty name disconnects it
+    void setBus(const String& sendBus, const String& returnBus);
+
+    // Publishes the input or output of the worker as sidechain source and/or reads the given sidechain source into the
+    // extra channels of the chain, an empty name disconnects it
+    void setSidechain(const String& publish, bool publishOutput, const String& source);
+
+    // Resumes a hibernated chain and restarts the idle time, should be called before accessing the processors
+    void wakeUp();
+
     struct ComparablePluginDescription : PluginDescription {
         ComparablePluginDescription(const PluginDescription& other) : PluginDescription(other) {}
         bool operator==(const ComparablePluginDescription& other) const { return isDuplicateOf(other); }
@@ -62,6 +83,7 @@ class AudioWorker : public Thread, public LogTagDelegate {
     using RecentsListType = Array<ComparablePluginDescription>;
     String getRecentsList(String host) const;
     void addToRecentsList(const String& id, const String& host);
+    void seedPluginPool(const String& host);
 
   private:
     std::unique_ptr<StreamingSocket> m_socket;
@@ -69,11 +91,35 @@ class AudioWorker : public Thread, public LogTagDelegate {
     int m_channelsOut;
     double m_rate;
     int m_samplesPerBlock;
+    int m_procBlockSize;
     bool m_doublePrecission;
+    // false for clients, that don't support silent channel flags in the audio headers
+    bool m_silentChannels = true;
     std::shared_ptr<ProcessorChain> m_chain;
+    std::atomic_bool m_wakeUp{false};
+    std::shared_ptr<SharedBus> m_sendBus, m_returnBus;
+    std::shared_ptr<SidechainSource> m_scPublish, m_scSource;
+    bool m_scPublishOutput = false;
+    std::mutex m_busMtx;
     static std::unordered_map<String, RecentsListType> m_recents;
     static std::mutex m_recentsMtx;
 
+    // The chain can process in larger blocks than the client sends
+    BlockAdapter<float> m_blockAdapterF;
+    BlockAdapter<double> m_blockAdapterD;
+
+    template <typename T>
+    void processBlock(AudioBuffer<T>& buffer, MidiBuffer& midi, BlockAdapter<T>& adapter) {
+        if (adapter.isEnabled()) {
+            adapter.process(buffer, midi, [this](AudioBuffer<T>& b, MidiBuffer& m) { m_chain->processBlock(b, m); });
+        } else {
+            m_chain->processBlock(buffer, midi);
+        }
+    }
+
+    // Checks if the memory budget of the server allows loading the given plugin in addition to the reserved memory
+    bool checkMemoryBudget(const String& id, int64 reserved, String& err);
+
     ENABLE_ASYNC_FUNCTORS();
 };
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef BlockAdapter_hpp
+#define BlockAdapter_hpp
+
+#include <JuceHeader.h>
+#include <cstring>
+
+namespace e47 {
+
+/*
+ * Re-blocks the audio/midi stream of a client into blocks of a fixed size. Incoming samples are collected until a
+ * full block is available, processed blocks are queued and handed out in the client block size. The output is
+ * delayed by blockSize - gcd(clientBlockSize, blockSize) samples, which is the minimum to never run dry.
+ */
+template <typename T>
+class BlockAdapter {
+  public:
+    using ProcessFn = std::function<void(AudioBuffer<T>&, MidiBuffer&)>;
+
+    void prepare(int channels, int clientBlockSize, int blockSize) {
+        m_blockSize = blockSize;
+        m_clientBlockSize = clientBlockSize;
+        if (!isEnabled()) {
+            m_latency = 0;
+            return;
+        }
+        int a = blockSize, b = clientBlockSize;
+        while (b > 0) {
+            int t = a % b;
+            a = b;
+            b = t;
+        }
+        m_latency = blockSize - a;
+        allocate(channels);
+        m_in.clear();
+        m_out.clear();
+        m_inMidi.clear();
+        m_outMidi.clear();
+        m_inCount = 0;
+        // pre-fill the output with silence
+        m_outCount = m_latency;
+    }
+
+    bool isEnabled() const { return m_blockSize > m_clientBlockSize && m_clientBlockSize > 0; }
+    int getLatencySamples() const { return m_latency; }
+
+    void process(AudioBuffer<T>& buffer, MidiBuffer& midi, ProcessFn fn) {
+        int numSamples = buffer.getNumSamples();
+        int channels = buffer.getNumChannels();
+        if (channels != m_in.getNumChannels() || numSamples > m_clientBlockSize) {
+            m_clientBlockSize = jmax(m_clientBlockSize, numSamples);
+            allocate(channels);
+        }
+
+        // collect the input
+        for (int c = 0; c < channels; c++) {
+            m_in.copyFrom(c, m_inCount, buffer, c, 0, numSamples);
+        }
+        m_inMidi.addEvents(midi, 0, numSamples, m_inCount);
+        m_inCount += numSamples;
+
+        // process full blocks
+        while (m_inCount >= m_blockSize) {
+            for (int c = 0; c < channels; c++) {
+                m_block.copyFrom(c, 0, m_in, c, 0, m_blockSize);
+            }
+            m_blockMidi.clear();
+            m_blockMidi.addEvents(m_inMidi, 0, m_blockSize, 0);
+            fn(m_block, m_blockMidi);
+            consume(m_in, m_inMidi, m_inCount, m_blockSize);
+            for (int c = 0; c < channels; c++) {
+                m_out.copyFrom(c, m_outCount, m_block, c, 0, m_blockSize);
+            }
+            m_outMidi.addEvents(m_blockMidi, 0, m_blockSize, m_outCount);
+            m_outCount += m_blockSize;
+        }
+
+        // hand out the processed samples
+        int available = jmin(numSamples, m_outCount);
+        for (int c = 0; c < channels; c++) {
+            buffer.copyFrom(c, 0, m_out, c, 0, available);
+            if (available < numSamples) {
+                buffer.clear(c, available, numSamples - available);
+            }
+        }
+        midi.clear();
+        midi.addEvents(m_outMidi, 0, available, 0);
+        consume(m_out, m_outMidi, m_outCount, available);
+    }
+
+  private:
+    int m_blockSize = 0;
+    int m_clientBlockSize = 0;
+    int m_latency = 0;
+    AudioBuffer<T> m_in, m_out, m_block;
+    MidiBuffer m_inMidi, m_outMidi, m_blockMidi, m_tmpMidi;
+    int m_inCount = 0;
+    int m_outCount = 0;
+
+    void allocate(int channels) {
+        m_in.setSize(channels, m_blockSize + m_clientBlockSize, true, true);
+        m_out.setSize(channels, m_latency + m_blockSize * 2 + m_clientBlockSize, true, true);
+        m_block.setSize(channels, m_blockSize);
+    }
+
+    // Removes the first num samples from the given buffer
+    void consume(AudioBuffer<T>& buf, MidiBuffer& midi, int& count, int num) {
+        count -= num;
+        for (int c = 0; c < buf.getNumChannels(); c++) {
+            auto* data = buf.getWritePointer(c);
+            std::memmove(data, data + num, (size_t)count * sizeof(T));
+        }
+        m_tmpMidi.clear();
+        m_tmpMidi.addEvents(midi, num, -1, -num);
+        midi.swapWith(m_tmpMidi);
+    }
+};
+
+}  // namespace e47
+
+#endif /* BlockAdapter_hpp */
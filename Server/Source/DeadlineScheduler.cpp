@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "DeadlineScheduler.hpp"
+
+namespace e47 {
+
+DeadlineScheduler::DeadlineScheduler() : LogTag("edf"), m_slots(jmax(1, SystemStats::getNumCpus())) {
+    logln("scheduling audio blocks earliest deadline first on " << m_slots << " slot(s)");
+}
+
+void DeadlineScheduler::acquire(int64 deadlineTicks) {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    auto it = m_waiting.insert(deadlineTicks);
+    m_cv.wait(lock, [this, it] { return m_busy < m_slots && it == m_waiting.begin(); });
+    m_waiting.erase(it);
+    m_busy++;
+    if (m_busy < m_slots && !m_waiting.empty()) {
+        // let the next waiter in
+        m_cv.notify_all();
+    }
+}
+
+void DeadlineScheduler::release() {
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_busy--;
+    }
+    m_cv.notify_all();
+}
+
+}  // namespace e47
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef DeadlineScheduler_hpp
+#define DeadlineScheduler_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <set>
+
+#include "SharedInstance.hpp"
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Earliest deadline first admission of audio blocks. Every audio worker requests a processing slot for a block with
+ * the deadline of the block. There is one slot per CPU core, so if more blocks are waiting than cores are
+ * available, the blocks with the earliest deadlines get processed first.
+ */
+class DeadlineScheduler : public LogTag, public SharedInstance<DeadlineScheduler> {
+  public:
+    DeadlineScheduler();
+
+    // Blocks until a slot is available and no other caller with an earlier deadline is waiting
+    void acquire(int64 deadlineTicks);
+    void release();
+
+    class ScopedSlot {
+      public:
+        ScopedSlot(std::shared_ptr<DeadlineScheduler> s, int64 deadlineTicks) : m_scheduler(s) {
+            if (nullptr != m_scheduler) {
+                m_scheduler->acquire(deadlineTicks);
+            }
+        }
+        ~ScopedSlot() {
+            if (nullptr != m_scheduler) {
+                m_scheduler->release();
+            }
+        }
+
+      private:
+        std::shared_ptr<DeadlineScheduler> m_scheduler;
+    };
+
+  private:
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::multiset<int64> m_waiting;
+    int m_slots;
+    int m_busy = 0;
+};
+
+}  // namespace e47
+
+#endif /* DeadlineScheduler_hpp */
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "MemoryInfo.hpp"
+
+#if defined(JUCE_MAC)
+#include <mach/mach.h>
+#elif defined(JUCE_WINDOWS)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace e47 {
+
+int64 MemoryInfo::getResidentBytes() {
+#if defined(JUCE_MAC)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS) {
+        return (int64)info.resident_size;
+    }
+#elif defined(JUCE_WINDOWS)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return (int64)pmc.WorkingSetSize;
+    }
+#else
+    // the second field of statm is the number of resident pages
+    auto fields = StringArray::fromTokens(File("/proc/self/statm").loadFileAsString(), " ", "");
+    if (fields.size() > 1) {
+        return fields[1].getLargeIntValue() * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+}  // namespace e47
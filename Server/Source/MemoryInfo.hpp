@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef MemoryInfo_hpp
+#define MemoryInfo_hpp
+
+#include <JuceHeader.h>
+
+namespace e47 {
+
+class MemoryInfo {
+  public:
+    // Returns the resident set size of the server process in bytes or 0, if it can't be determined
+    static int64 getResidentBytes();
+
+    static String toMBString(int64 bytes) { return String(bytes / 1024.0 / 1024.0, 1) + " MB"; }
+};
+
+}  // namespace e47
+
+#endif /* MemoryInfo_hpp */
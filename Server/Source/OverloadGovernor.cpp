@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "OverloadGovernor.hpp"
+#include "ProcessorChain.hpp"
+#include "Metrics.hpp"
+#include "App.hpp"
+#include "Server.hpp"
+
+namespace e47 {
+
+OverloadGovernor::~OverloadGovernor() {
+    traceScope();
+    stopThread(-1);
+}
+
+void OverloadGovernor::run() {
+    traceScope();
+    logln("overload governor started");
+    auto misses = Metrics::getStatistic<Meter>("DeadlineMiss");
+    auto lastTotal = misses->total();
+    while (!currentThreadShouldExit()) {
+        wait(1000);
+        if (currentThreadShouldExit()) {
+            break;
+        }
+        auto& srv = getApp()->getServer();
+        m_screenThrottled = srv.getOverloadReduceScreen();
+        m_addPluginRefused = srv.getOverloadRefuseAddPlugin();
+        int threshold = srv.getOverloadMissesPerSec();
+        auto total = misses->total();
+        auto missed = total - lastTotal;
+        lastTotal = total;
+        if (threshold <= 0) {
+            // the protection has been turned off, revert all actions
+            while (m_level > NORMAL) {
+                deescalate();
+            }
+            m_overloadSecs = m_calmSecs = 0;
+            continue;
+        }
+        if (missed >= (uint64)threshold) {
+            m_overloadSecs++;
+            m_calmSecs = 0;
+        } else {
+            m_calmSecs++;
+            m_overloadSecs = 0;
+        }
+        if (m_overloadSecs >= SUSTAIN_SECS) {
+            escalate();
+            m_overloadSecs = 0;
+        } else if (m_calmSecs >= RECOVER_SECS && m_level > NORMAL) {
+            deescalate();
+            m_calmSecs = 0;
+        }
+    }
+    logln("overload governor terminated");
+}
+
+void OverloadGovernor::addChain(std::shared_ptr<ProcessorChain> chain) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_chainsMtx);
+    m_chains.push_back(chain);
+}
+
+void OverloadGovernor::removeChain(std::shared_ptr<ProcessorChain> chain) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_chainsMtx);
+    for (auto it = m_chains.begin(); it != m_chains.end();) {
+        auto c = it->lock();
+        if (nullptr == c || c == chain) {
+            it = m_chains.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+uint64 OverloadGovernor::getEventSeq() {
+    std::lock_guard<std::mutex> lock(m_eventsMtx);
+    return m_eventSeq;
+}
+
+StringArray OverloadGovernor::getEvents(uint64& seq) {
+    StringArray events;
+    std::lock_guard<std::mutex> lock(m_eventsMtx);
+    for (auto& e : m_events) {
+        if (e.seq > seq) {
+            events.add(e.text);
+        }
+    }
+    seq = m_eventSeq;
+    return events;
+}
+
+bool OverloadGovernor::isEnabled(int level) const {
+    switch (level) {
+        case SCREEN_THROTTLED:
+            return m_screenThrottled;
+        case ADD_PLUGIN_REFUSED:
+            return m_addPluginRefused;
+        case AUTO_BYPASS:
+            return getApp()->getServer().getOverloadAutoBypass();
+    }
+    return false;
+}
+
+void OverloadGovernor::escalate() {
+    traceScope();
+    for (int level = m_level + 1; level <= AUTO_BYPASS; level++) {
+        if (isEnabled(level)) {
+            setLevel(level);
+            if (level == AUTO_BYPASS) {
+                bypassMostExpensive();
+            }
+            return;
+        }
+    }
+    // bypass one more plugin for every period of sustained overload
+    if (m_level == AUTO_BYPASS && isEnabled(AUTO_BYPASS)) {
+        bypassMostExpensive();
+    }
+}
+
+void OverloadGovernor::deescalate() {
+    traceScope();
+    if (restoreLastBypassed()) {
+        return;
+    }
+    int level = m_level - 1;
+    while (level > NORMAL && !isEnabled(level)) {
+        level--;
+    }
+    setLevel(level);
+}
+
+void OverloadGovernor::setLevel(int level) {
+    traceScope();
+    if (level == m_level) {
+        return;
+    }
+    String text = level > m_level ? "server overloaded, " : "server load recovered, ";
+    switch (level) {
+        case NORMAL:
+            text << "back to normal operation";
+            break;
+        case SCREEN_THROTTLED:
+            text << "reducing the screen capturing frame rate";
+            break;
+        case ADD_PLUGIN_REFUSED:
+            text << "refusing to add plugins";
+            break;
+        case AUTO_BYPASS:
+            text << "bypassing expensive plugins";
+            break;
+    }
+    m_level = level;
+    addEvent(text);
+}
+
+bool OverloadGovernor::bypassMostExpensive() {
+    traceScope();
+    std::shared_ptr<AGProcessor> candidate;
+    double maxLoad = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_chainsMtx);
+        for (auto& weakChain : m_chains) {
+            auto chain = weakChain.lock();
+            if (nullptr == chain) {
+                continue;
+            }
+            for (int i = 0; i < (int)chain->getSize(); i++) {
+                auto proc = chain->getProcessor(i);
+                if (nullptr == proc || proc->isSuspended() || proc->isGovernorBypassed()) {
+                    continue;
+                }
+                // bypassing an instrument would silence the chain
+                auto plugin = proc->getPlugin();
+                if (nullptr == plugin || plugin->getPluginDescription().isInstrument) {
+                    continue;
+                }
+                auto load = proc->getDSPStats().load;
+                if (load > maxLoad) {
+                    maxLoad = load;
+                    candidate = proc;
+                }
+            }
+        }
+    }
+    if (nullptr == candidate) {
+        return false;
+    }
+    candidate->setGovernorBypassed(true);
+    m_bypassed.push_back(candidate);
+    addEvent("bypassing " + candidate->getName() + " (" + String(maxLoad, 1) + "% DSP load)");
+    return true;
+}
+
+bool OverloadGovernor::restoreLastBypassed() {
+    traceScope();
+    while (!m_bypassed.empty()) {
+        auto proc = m_bypassed.back().lock();
+        m_bypassed.pop_back();
+        // skip plugins, that have been deleted meanwhile
+        if (nullptr != proc && proc->isGovernorBypassed()) {
+            proc->setGovernorBypassed(false);
+            addEvent("unbypassing " + proc->getName());
+            return true;
+        }
+    }
+    return false;
+}
+
+void OverloadGovernor::addEvent(const String& text) {
+    traceScope();
+    logln(text);
+    std::lock_guard<std::mutex> lock(m_eventsMtx);
+    m_events.push_back({++m_eventSeq, text});
+    while (m_events.size() > MAX_EVENTS) {
+        m_events.pop_front();
+    }
+}
+
+}  // namespace e47
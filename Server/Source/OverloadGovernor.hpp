@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef OverloadGovernor_hpp
+#define OverloadGovernor_hpp
+
+#include <JuceHeader.h>
+#include <deque>
+
+#include "SharedInstance.hpp"
+#include "Utils.hpp"
+
+namespace e47 {
+
+class ProcessorChain;
+class AGProcessor;
+
+/*
+ * Watches the deadline misses of all audio workers. When the server is overloaded for a while, the governor degrades
+ * the service step by step: it reduces the screen capturing frame rate, refuses to add new plugins and finally
+ * bypasses the most expensive effect plugins one by one. When the overload is gone, the steps get reverted in
+ * reverse order. Every action is recorded as an event, that the workers hand out to their clients.
+ */
+class OverloadGovernor : public Thread, public LogTag, public SharedInstance<OverloadGovernor> {
+  public:
+    enum Level { NORMAL, SCREEN_THROTTLED, ADD_PLUGIN_REFUSED, AUTO_BYPASS };
+
+    // Minimum time between two screen frames, while the screen capturing is throttled
+    static constexpr uint32 SCREEN_INTERVAL_MS = 200;
+
+    OverloadGovernor() : Thread("OverloadGovernor"), LogTag("governor") { startThread(); }
+    ~OverloadGovernor() override;
+
+    void run() override;
+
+    void addChain(std::shared_ptr<ProcessorChain> chain);
+    void removeChain(std::shared_ptr<ProcessorChain> chain);
+
+    int getLevel() const { return m_level; }
+    bool isScreenThrottled() const { return m_level >= SCREEN_THROTTLED && m_screenThrottled; }
+    bool isAddPluginRefused() const { return m_level >= ADD_PLUGIN_REFUSED && m_addPluginRefused; }
+
+    // Returns the sequence number of the last event
+    uint64 getEventSeq();
+
+    // Returns the events after the given sequence number and updates the sequence number
+    StringArray getEvents(uint64& seq);
+
+  private:
+    std::atomic_int m_level{NORMAL};
+    std::atomic_bool m_screenThrottled{false};
+    std::atomic_bool m_addPluginRefused{false};
+    int m_overloadSecs = 0;
+    int m_calmSecs = 0;
+
+    std::vector<std::weak_ptr<ProcessorChain>> m_chains;
+    std::mutex m_chainsMtx;
+    std::vector<std::weak_ptr<AGProcessor>> m_bypassed;
+
+    struct Event {
+        uint64 seq;
+        String text;
+    };
+    std::deque<Event> m_events;
+    uint64 m_eventSeq = 0;
+    std::mutex m_eventsMtx;
+
+    static constexpr int SUSTAIN_SECS = 5;
+    static constexpr int RECOVER_SECS = 30;
+    static constexpr size_t MAX_EVENTS = 100;
+
+    bool isEnabled(int level) const;
+    void escalate();
+    void deescalate();
+    void setLevel(int level);
+    bool bypassMostExpensive();
+    bool restoreLastBypassed();
+    void addEvent(const String& text);
+};
+
+}  // namespace e47
+
+#endif /* OverloadGovernor_hpp */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "ParameterSubscription.hpp"
+#include "ScreenWorker.hpp"
+#include "ProcessorChain.hpp"
+
+namespace e47 {
+
+ParameterSubscription::ParameterSubscription(LogTag* tag, int idx, std::shared_ptr<AGProcessor> proc,
+                                             std::shared_ptr<ScreenWorker> screen)
+    : Thread("ParameterSubscription"), LogTagDelegate(tag), m_idx(idx), m_proc(proc), m_screen(screen) {
+    traceScope();
+    m_paramIndexes = proc->getParameterIndexes();
+    m_dirty = std::make_unique<std::atomic_bool[]>(m_paramIndexes.size());
+    for (size_t i = 0; i < m_paramIndexes.size(); i++) {
+        m_positions[m_paramIndexes[i]] = (int)i;
+        m_dirty[i] = false;
+    }
+    proc->setParameterListener(this);
+    logln("subscribed to " << m_paramIndexes.size() << " parameters of plugin " << m_idx);
+    startThread();
+}
+
+ParameterSubscription::~ParameterSubscription() {
+    traceScope();
+    if (auto proc = m_proc.lock()) {
+        proc->setParameterListener(nullptr);
+    }
+    stopThread(-1);
+    logln("unsubscribed from parameters of plugin " << m_idx);
+}
+
+void ParameterSubscription::parameterValueChanged(int parameterIndex, float /* newValue */) {
+    auto it = m_positions.find(parameterIndex);
+    if (it != m_positions.end()) {
+        m_dirty[(size_t)it->second] = true;
+        m_changed = true;
+    }
+}
+
+void ParameterSubscription::run() {
+    traceScope();
+    while (!threadShouldExit()) {
+        wait(FRAME_MS);
+        if (!m_changed.exchange(false)) {
+            continue;
+        }
+        auto proc = m_proc.lock();
+        if (nullptr == proc) {
+            break;
+        }
+        // same format as the reply to GetAllParameterValues, but with the changed values only
+        MemoryOutputStream out;
+        out.writeInt(m_idx);
+        for (size_t i = 0; i < m_paramIndexes.size(); i++) {
+            float value;
+            if (m_dirty[i].exchange(false) && proc->getParameterValue(m_paramIndexes[i], value)) {
+                out.writeInt(m_paramIndexes[i]);
+                out.writeFloat(value);
+            }
+        }
+        proc.reset();
+        if (!m_screen->sendParameterValues(out.getMemoryBlock())) {
+            logln("failed to send parameter values");
+            break;
+        }
+    }
+}
+
+}  // namespace e47
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef ParameterSubscription_hpp
+#define ParameterSubscription_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+class ScreenWorker;
+class AGProcessor;
+
+/*
+ * Listens to the parameters of a plugin and pushes changed values to the client via the screen connection. Changes
+ * are coalesced and sent at most once per UI frame, so that a plugin changing thousands of parameters at once results
+ * in a single message. The subscription does not own the plugin, the processor attaches the listener again, when
+ * hibernation reloads the plugin.
+ */
+class ParameterSubscription : public Thread,
+                              public AudioProcessorParameter::Listener,
+                              public LogTagDelegate {
+  public:
+    static constexpr int FRAME_MS = 33;
+
+    ParameterSubscription(LogTag* tag, int idx, std::shared_ptr<AGProcessor> proc,
+                          std::shared_ptr<ScreenWorker> screen);
+    ~ParameterSubscription() override;
+
+    void run() override;
+
+    int getIndex() const { return m_idx; }
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+
+  private:
+    int m_idx;
+    std::weak_ptr<AGProcessor> m_proc;
+    std::shared_ptr<ScreenWorker> m_screen;
+
+    // the listener gets called from any thread, including the audio thread, so changes are only flagged
+    std::vector<int> m_paramIndexes;
+    std::unordered_map<int, int> m_positions;
+    std::unique_ptr<std::atomic_bool[]> m_dirty;
+    std::atomic_bool m_changed{false};
+};
+
+}  // namespace e47
+
+#endif /* ParameterSubscription_hpp */
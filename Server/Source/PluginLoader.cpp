@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "PluginLoader.hpp"
+#include "ProcessorChain.hpp"
+#include "Metrics.hpp"
+
+namespace e47 {
+
+PluginLoader::~PluginLoader() {
+    traceScope();
+    shutdown();
+}
+
+void PluginLoader::configure(int numOfWorkers, const LimitsMap& formatLimits, const LimitsMap& vendorLimits) {
+    traceScope();
+    numOfWorkers = jmax(1, numOfWorkers);
+    logln("using " << numOfWorkers << " loader worker(s)");
+    for (auto& l : formatLimits) {
+        logln("  format " << l.first << ": max " << l.second << " concurrent job(s)");
+    }
+    for (auto& l : vendorLimits) {
+        logln("  vendor " << l.first << ": max " << l.second << " concurrent job(s)");
+    }
+    std::lock_guard<std::mutex> lock(m_queueMtx);
+    m_formatLimits = formatLimits;
+    m_vendorLimits = vendorLimits;
+    while (m_workers.size() < (size_t)numOfWorkers) {
+        m_workers.push_back(std::make_unique<Worker>(*this, (int)m_workers.size()));
+        m_workers.back()->startThread();
+    }
+}
+
+void PluginLoader::shutdown() {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_queueMtx);
+        m_shutdown = true;
+        for (auto& w : m_workers) {
+            w->signalThreadShouldExit();
+        }
+    }
+    m_queueCv.notify_all();
+    for (auto& w : m_workers) {
+        waitForThreadAndLog(this, w.get());
+    }
+    m_workers.clear();
+    std::list<std::shared_ptr<Job>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMtx);
+        Metrics::getStatistic<Gauge>("PluginLoadQueue")->decrement((int64)m_queue.size());
+        dropped.swap(m_queue);
+    }
+    for (auto& job : dropped) {
+        finish(*job);
+    }
+}
+
+bool PluginLoader::execute(const String& id, Priority prio, std::function<bool()> fn) {
+    traceScope();
+    auto job = createJob(id, prio, std::move(fn));
+    auto waitTime = TimeStatistic::getDuration("PluginLoadWait");
+    if (!enqueue(job)) {
+        return false;
+    }
+    job->done.wait();
+    waitTime.update();
+    return job->result;
+}
+
+void PluginLoader::submit(const String& id, Priority prio, std::function<bool()> fn,
+                          std::function<void(bool)> onDone) {
+    traceScope();
+    auto job = createJob(id, prio, std::move(fn));
+    job->onDone = std::move(onDone);
+    if (!enqueue(job)) {
+        finish(*job);
+    }
+}
+
+std::shared_ptr<PluginLoader::Job> PluginLoader::createJob(const String& id, Priority prio,
+                                                           std::function<bool()> fn) {
+    auto job = std::make_shared<Job>();
+    job->prio = prio;
+    job->fn = std::move(fn);
+    if (auto desc = AGProcessor::findPluginDescritpion(id)) {
+        job->format = desc->pluginFormatName;
+        job->vendor = desc->manufacturerName;
+    }
+    return job;
+}
+
+bool PluginLoader::enqueue(std::shared_ptr<Job> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMtx);
+        if (m_shutdown) {
+            return false;
+        }
+        // keep the queue ordered by priority and arrival
+        auto it = m_queue.begin();
+        while (it != m_queue.end() && (*it)->prio >= job->prio) {
+            it++;
+        }
+        m_queue.insert(it, job);
+        Metrics::getStatistic<Gauge>("PluginLoadQueue")->increment();
+    }
+    m_queueCv.notify_one();
+    return true;
+}
+
+void PluginLoader::finish(Job& job) {
+    // called without holding the queue lock, the callback might take a while
+    if (job.onDone) {
+        job.onDone(job.result);
+        job.onDone = nullptr;
+    }
+    job.done.signal();
+}
+
+bool PluginLoader::isAllowedNoLock(const Job& job) {
+    auto fl = m_formatLimits.find(job.format);
+    if (fl != m_formatLimits.end() && fl->second > 0 && m_formatRunning[job.format] >= fl->second) {
+        return false;
+    }
+    auto vl = m_vendorLimits.find(job.vendor);
+    if (vl != m_vendorLimits.end() && vl->second > 0 && m_vendorRunning[job.vendor] >= vl->second) {
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<PluginLoader::Job> PluginLoader::nextJobNoLock() {
+    for (auto it = m_queue.begin(); it != m_queue.end(); it++) {
+        if (isAllowedNoLock(**it)) {
+            auto job = *it;
+            m_queue.erase(it);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void PluginLoader::runWorker(Thread& thread) {
+    traceScope();
+    auto queueDepth = Metrics::getStatistic<Gauge>("PluginLoadQueue");
+    std::unique_lock<std::mutex> lock(m_queueMtx);
+    while (!thread.threadShouldExit()) {
+        auto job = nextJobNoLock();
+        if (nullptr == job) {
+            m_queueCv.wait_for(lock, std::chrono::milliseconds(500));
+            continue;
+        }
+        queueDepth->decrement();
+        // a failing job can only teach us something, if it had company from the same vendor
+        job->learnable = job->vendor.isNotEmpty() && m_vendorRunning[job->vendor] > 0;
+        m_formatRunning[job->format]++;
+        m_vendorRunning[job->vendor]++;
+        lock.unlock();
+
+        auto duration = TimeStatistic::getDuration("PluginLoad");
+        job->result = job->fn();
+        duration.update();
+
+        lock.lock();
+        m_formatRunning[job->format]--;
+        m_vendorRunning[job->vendor]--;
+        if (!job->result && job->learnable && m_vendorLimits[job->vendor] != 1) {
+            logln("job for vendor " << job->vendor
+                                    << " failed while running concurrently, limiting to one concurrent job");
+            m_vendorLimits[job->vendor] = 1;
+        }
+        m_queueCv.notify_all();
+        lock.unlock();
+        finish(*job);
+        lock.lock();
+    }
+}
+
+}  // namespace e47
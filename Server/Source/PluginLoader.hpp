@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef PluginLoader_hpp
+#define PluginLoader_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+#include "SharedInstance.hpp"
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Schedules plugin load/unload jobs on a bounded number of loader workers. The number of concurrent jobs for a
+ * plugin format or vendor can be limited via config. Vendors, that fail to load while other plugins of the same
+ * vendor are loading, get limited to one job at a time automatically. Jobs of clients with running audio are
+ * executed first.
+ */
+class PluginLoader : public LogTag, public SharedInstance<PluginLoader> {
+  public:
+    enum Priority { PRIO_BACKGROUND, PRIO_NORMAL, PRIO_AUDIO_RUNNING };
+
+    using LimitsMap = std::map<String, int>;
+
+    PluginLoader() : LogTag("pluginloader") {}
+    ~PluginLoader() override;
+
+    // A number of workers of 1 serializes all jobs. Limits of 0 mean no limit.
+    void configure(int numOfWorkers, const LimitsMap& formatLimits, const LimitsMap& vendorLimits);
+
+    // Executes fn on a loader worker as soon as the limits for the given plugin allow it and blocks until fn has
+    // been executed. Returns the result of fn or false if the loader has been shut down.
+    bool execute(const String& id, Priority prio, std::function<bool()> fn);
+
+    // Like execute, but returns right away. onDone is called with the result of fn on the loader worker, or with
+    // false if the loader has been shut down.
+    void submit(const String& id, Priority prio, std::function<bool()> fn, std::function<void(bool)> onDone);
+
+    void shutdown();
+
+  private:
+    struct Job {
+        Priority prio;
+        String format;
+        String vendor;
+        std::function<bool()> fn;
+        std::function<void(bool)> onDone;
+        bool result = false;
+        bool learnable = false;
+        WaitableEvent done;
+    };
+
+    class Worker : public Thread {
+      public:
+        Worker(PluginLoader& loader, int num) : Thread("PluginLoader-" + String(num)), m_loader(loader) {}
+        void run() override { m_loader.runWorker(*this); }
+
+      private:
+        PluginLoader& m_loader;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::list<std::shared_ptr<Job>> m_queue;
+    std::mutex m_queueMtx;
+    std::condition_variable m_queueCv;
+    bool m_shutdown = false;
+
+    LimitsMap m_formatLimits, m_vendorLimits;
+    std::unordered_map<String, int> m_formatRunning, m_vendorRunning;
+
+    std::shared_ptr<Job> createJob(const String& id, Priority prio, std::function<bool()> fn);
+    bool enqueue(std::shared_ptr<Job> job);
+    void finish(Job& job);
+    void runWorker(Thread& thread);
+    std::shared_ptr<Job> nextJobNoLock();
+    bool isAllowedNoLock(const Job& job);
+};
+
+}  // namespace e47
+
+#endif /* PluginLoader_hpp */
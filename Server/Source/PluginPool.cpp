@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "PluginPool.hpp"
+#include "ProcessorChain.hpp"
+#include "PluginLoader.hpp"
+#include "MemoryInfo.hpp"
+#include "Metrics.hpp"
+#include "App.hpp"
+
+namespace e47 {
+
+PluginPool::~PluginPool() {
+    traceScope();
+    stopThread(-1);
+    clear();
+}
+
+void PluginPool::seed(const String& id, const Format& fmt) {
+    traceScope();
+    auto key = getKey(id, fmt);
+    std::lock_guard<std::mutex> lock(m_entriesMtx);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        logln("seeding " << key);
+        Entry e;
+        e.id = id;
+        e.fmt = fmt;
+        e.lastUsed = Time::getMillisecondCounter();
+        m_entries[key] = std::move(e);
+        notify();
+    } else {
+        it->second.lastUsed = Time::getMillisecondCounter();
+    }
+}
+
+std::shared_ptr<AudioPluginInstance> PluginPool::take(const String& id, const Format& fmt, int64& memBytes) {
+    traceScope();
+    memBytes = 0;
+    if (getApp()->getServer().getPluginPoolSize() < 1) {
+        return nullptr;
+    }
+    std::shared_ptr<AudioPluginInstance> inst;
+    auto key = getKey(id, fmt);
+    {
+        std::lock_guard<std::mutex> lock(m_entriesMtx);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            auto& e = it->second;
+            e.lastUsed = Time::getMillisecondCounter();
+            if (!e.instances.empty()) {
+                inst = e.instances.back().plugin;
+                memBytes = e.instances.back().memBytes;
+                e.instances.pop_back();
+            }
+        }
+    }
+    if (nullptr != inst) {
+        logln("handing out warm instance for " << key << ", memory " << MemoryInfo::toMBString(memBytes));
+        Metrics::getStatistic<Meter>("PluginPoolHit")->increment();
+    } else {
+        Metrics::getStatistic<Meter>("PluginPoolMiss")->increment();
+    }
+    // refill or create the entry
+    seed(id, fmt);
+    notify();
+    return inst;
+}
+
+void PluginPool::prepare(AudioPluginInstance& inst, const Format& fmt) {
+    // prepare the instance the same way a chain does, so that the chain can skip preparing it again
+    auto layout = ProcessorChain::createBusesLayout(fmt.channelsIn, fmt.channelsOut);
+    if (inst.checkBusesLayoutSupported(layout)) {
+        inst.setBusesLayout(layout);
+    }
+    bool useDouble = fmt.doublePrecision && inst.supportsDoublePrecisionProcessing();
+    inst.setProcessingPrecision(useDouble ? AudioProcessor::doublePrecision : AudioProcessor::singlePrecision);
+    inst.prepareToPlay(fmt.sampleRate, fmt.blockSize);
+    int channels = jmax(inst.getTotalNumInputChannels(), inst.getTotalNumOutputChannels());
+    if (useDouble) {
+        ProcessorChain::preProcessBlocks<double>(inst, channels, fmt.blockSize);
+    } else {
+        ProcessorChain::preProcessBlocks<float>(inst, channels, fmt.blockSize);
+    }
+}
+
+void PluginPool::clear() {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_entriesMtx);
+    m_entries.clear();
+}
+
+void PluginPool::expireNoLock(int poolSize) {
+    traceScope();
+    auto now = Time::getMillisecondCounter();
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (poolSize < 1 || now - it->second.lastUsed > (uint32)Defaults::PLUGIN_POOL_EXPIRE_MS) {
+            logln("expiring " << it->first);
+            it = m_entries.erase(it);
+        } else {
+            if (it->second.instances.size() > (size_t)poolSize) {
+                it->second.instances.resize((size_t)poolSize);
+            }
+            ++it;
+        }
+    }
+    // drop the least recently used entries
+    while (m_entries.size() > (size_t)Defaults::PLUGIN_POOL_MAX_ENTRIES) {
+        auto lru = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->second.lastUsed < lru->second.lastUsed) {
+                lru = it;
+            }
+        }
+        logln("evicting " << lru->first);
+        m_entries.erase(lru);
+    }
+}
+
+void PluginPool::run() {
+    traceScope();
+    logln("plugin pool started");
+    while (!currentThreadShouldExit()) {
+        int poolSize = getApp()->getServer().getPluginPoolSize();
+        String key, id;
+        Format fmt;
+        {
+            std::lock_guard<std::mutex> lock(m_entriesMtx);
+            expireNoLock(poolSize);
+            for (auto& kv : m_entries) {
+                auto& e = kv.second;
+                if (!e.failed && e.instances.size() < (size_t)poolSize) {
+                    key = kv.first;
+                    id = e.id;
+                    fmt = e.fmt;
+                    break;
+                }
+            }
+        }
+        if (key.isEmpty()) {
+            wait(1000);
+            continue;
+        }
+
+        String err;
+        std::shared_ptr<AudioPluginInstance> inst;
+        int64 memBytes = 0;
+        auto fn = [&] {
+            // the memory of the instance gets charged to the processor, that takes it
+            auto memBefore = MemoryInfo::getResidentBytes();
+            inst = AGProcessor::loadPlugin(id, fmt.sampleRate, fmt.blockSize, err);
+            if (nullptr != inst) {
+                prepare(*inst, fmt);
+                memBytes = jmax((int64)0, MemoryInfo::getResidentBytes() - memBefore);
+                return true;
+            }
+            return false;
+        };
+        auto loader = PluginLoader::getInstance();
+        if (nullptr == loader || !loader->execute(id, PluginLoader::PRIO_BACKGROUND, fn)) {
+            if (nullptr == inst && err.isEmpty()) {
+                // the loader is gone, we are shutting down
+                wait(1000);
+                continue;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_entriesMtx);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            if (nullptr != inst) {
+                it->second.instances.push_back({inst, memBytes});
+                logln("warm instances for " << key << ": " << it->second.instances.size());
+            } else {
+                logln("disabling pooling for " << key << ": " << err);
+                it->second.failed = true;
+            }
+        }
+    }
+    logln("plugin pool terminated");
+}
+
+}  // namespace e47
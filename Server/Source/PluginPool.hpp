@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef PluginPool_hpp
+#define PluginPool_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+#include "SharedInstance.hpp"
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Keeps pre-instantiated and prepared plugin instances for frequently used plugins, so that adding a plugin to a
+ * chain does not have to wait for the plugin to be created. The pool is seeded from the recents lists of the
+ * connected clients and refilled in the background after an instance has been handed out.
+ */
+class PluginPool : public Thread, public LogTag, public SharedInstance<PluginPool> {
+  public:
+    PluginPool() : Thread("PluginPool"), LogTag("pluginpool") { startThread(); }
+    ~PluginPool() override;
+
+    void run() override;
+
+    // The audio format, that the warm instances are prepared for
+    struct Format {
+        double sampleRate = 0;
+        int blockSize = 0;
+        int channelsIn = 0;
+        int channelsOut = 0;
+        bool doublePrecision = false;
+    };
+
+    // Request warm instances for the given plugin and audio format
+    void seed(const String& id, const Format& fmt);
+
+    // Returns a warm instance or nullptr, if there is none available. The instance has been prepared for the given
+    // format already. memBytes is set to the memory, that has been measured when the pool created the instance.
+    std::shared_ptr<AudioPluginInstance> take(const String& id, const Format& fmt, int64& memBytes);
+
+    void clear();
+
+  private:
+    struct Instance {
+        std::shared_ptr<AudioPluginInstance> plugin;
+        int64 memBytes;
+    };
+
+    struct Entry {
+        String id;
+        Format fmt;
+        std::vector<Instance> instances;
+        uint32 lastUsed;
+        bool failed = false;
+    };
+
+    std::unordered_map<String, Entry> m_entries;
+    std::mutex m_entriesMtx;
+
+    static String getKey(const String& id, const Format& fmt) {
+        return id + "@" + String(fmt.sampleRate) + "/" + String(fmt.blockSize) + "/" + String(fmt.channelsIn) + ":" +
+               String(fmt.channelsOut) + (fmt.doublePrecision ? "/d" : "/f");
+    }
+
+    static void prepare(AudioPluginInstance& inst, const Format& fmt);
+
+    void expireNoLock(int poolSize);
+};
+
+}  // namespace e47
+
+#endif /* PluginPool_hpp */
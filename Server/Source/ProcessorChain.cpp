@@ -8,12 +8,16 @@
 #include "ProcessorChain.hpp"
 #include "NumberConversion.hpp"
 #include "App.hpp"
+#include "PluginPool.hpp"
+#include "PluginLoader.hpp"
+#include "MemoryInfo.hpp"
 
 namespace e47 {
 
 std::atomic_uint32_t AGProcessor::count{0};
 std::atomic_uint32_t AGProcessor::loadedCount{0};
-std::mutex AGProcessor::m_pluginLoaderMtx;
+std::unordered_map<String, int64> AGProcessor::m_expectedMemory;
+std::mutex AGProcessor::m_expectedMemoryMtx;
 
 AGProcessor::AGProcessor(ProcessorChain& chain, const String& id, double sampleRate, int blockSize)
     : LogTagDelegate(chain.getLogTagSource()),
@@ -132,30 +136,98 @@ std::shared_ptr<AudioPluginInstance> AGProcessor::loadPlugin(const String& id, d
 bool AGProcessor::load(String& err) {
     traceScope();
     bool loaded = false;
-    std::shared_ptr<AudioPluginInstance> p;
+    WaitableEvent done;
+    loadAsync([&](bool ok, const String& e) {
+        loaded = ok;
+        err = e;
+        done.signal();
+    });
+    done.wait();
+    return loaded;
+}
+
+void AGProcessor::loadAsync(std::function<void(bool, const String&)> onDone) {
+    traceScope();
     {
         std::lock_guard<std::mutex> lock(m_pluginMtx);
-        p = m_plugin;
+        if (nullptr != m_plugin) {
+            onDone(false, {});
+            return;
+        }
     }
-    if (nullptr == p) {
-        bool parallelAllowed = getApp()->getServer().getParallelPluginLoad();
-        if (!parallelAllowed) {
-            m_pluginLoaderMtx.lock();
-        }
-        p = loadPlugin(m_id, m_sampleRate, m_blockSize, err);
-        if (nullptr != p) {
-            if (m_chain.initPluginInstance(p, m_extraInChannels, m_extraOutChannels, err)) {
-                loaded = true;
-                std::lock_guard<std::mutex> lock(m_pluginMtx);
-                m_plugin = p;
-                loadedCount++;
-            }
+    struct Context {
+        std::shared_ptr<AudioPluginInstance> plugin;
+        int64 memBytes = 0;
+        bool fresh = true;
+        String err;
+    };
+    auto ctx = std::make_shared<Context>();
+    if (auto pool = PluginPool::getInstance()) {
+        PluginPool::Format fmt;
+        fmt.sampleRate = m_sampleRate;
+        fmt.blockSize = m_blockSize;
+        fmt.channelsIn = m_chain.getMainBusNumInputChannels();
+        fmt.channelsOut = m_chain.getMainBusNumOutputChannels();
+        fmt.doublePrecision = m_chain.isUsingDoublePrecision();
+        ctx->plugin = pool->take(m_id, fmt, ctx->memBytes);
+    }
+    auto prio = m_chain.isProcessing() ? PluginLoader::PRIO_AUDIO_RUNNING : PluginLoader::PRIO_NORMAL;
+    ctx->fresh = nullptr == ctx->plugin;
+    auto fn = [this, ctx] {
+        auto memBefore = MemoryInfo::getResidentBytes();
+        if (nullptr == ctx->plugin) {
+            ctx->plugin = loadPlugin(m_id, m_sampleRate, m_blockSize, ctx->err);
+        }
+        bool ok = nullptr != ctx->plugin && m_chain.initPluginInstance(ctx->plugin, m_extraInChannels,
+                                                                      m_extraOutChannels, ctx->err, !ctx->fresh);
+        // pooled instances add the memory, that the pool measured when creating them
+        ctx->memBytes += jmax((int64)0, MemoryInfo::getResidentBytes() - memBefore);
+        return ok;
+    };
+    auto finish = [this, ctx, onDone](bool ok) {
+        if (ok) {
+            setLoaded(ctx->plugin, ctx->memBytes);
+        } else if (ctx->err.isEmpty()) {
+            ctx->err = "plugin loader has been shut down";
         }
-        if (!parallelAllowed) {
-            m_pluginLoaderMtx.unlock();
+        onDone(ok, ctx->err);
+    };
+    auto loader = PluginLoader::getInstance();
+    if (nullptr != loader) {
+        loader->submit(m_id, prio, fn, finish);
+    } else {
+        finish(fn());
+    }
+}
+
+void AGProcessor::setLoaded(std::shared_ptr<AudioPluginInstance> p, int64 memBytes) {
+    traceScope();
+    m_dspStatName =
+        DSP_STAT_PREFIX + getExtra() + "|" + p->getName() + "|" + String::toHexString((pointer_sized_int)this);
+    m_dspTime = Metrics::getStatistic<TimeStatistic>(m_dspStatName, (size_t)20, 0.25);
+    m_dspTime->setShowLog(false);
+    m_memBytes = memBytes;
+    m_memStatName =
+        MEM_STAT_PREFIX + getExtra() + "|" + p->getName() + "|" + String::toHexString((pointer_sized_int)this);
+    auto memGauge = Metrics::getStatistic<Gauge>(m_memStatName);
+    memGauge->setShowLog(false);
+    memGauge->set(m_memBytes);
+    Metrics::getStatistic<Gauge>("PluginMemory")->increment(m_memBytes);
+    logln("loaded " << p->getName() << ", memory " << MemoryInfo::toMBString(m_memBytes));
+    {
+        std::lock_guard<std::mutex> lock(m_expectedMemoryMtx);
+        m_expectedMemory[m_id] = m_memBytes;
+    }
+    std::lock_guard<std::mutex> lock(m_pluginMtx);
+    m_plugin = p;
+    m_paramIndex.clear();
+    for (auto* param : p->getParameters()) {
+        m_paramIndex[param->getParameterIndex()] = param;
+        if (nullptr != m_paramListener) {
+            param->addListener(m_paramListener);
         }
     }
-    return loaded;
+    loadedCount++;
 }
 
 void AGProcessor::unload() {
@@ -167,19 +239,112 @@ void AGProcessor::unload() {
             if (m_prepared) {
                 m_plugin->releaseResources();
             }
+            if (nullptr != m_paramListener) {
+                for (auto* param : m_plugin->getParameters()) {
+                    param->removeListener(m_paramListener);
+                }
+            }
             p = m_plugin;
             m_plugin.reset();
+            m_paramIndex.clear();
             loadedCount--;
         }
     }
-    bool parallelAllowed = getApp()->getServer().getParallelPluginLoad();
-    if (!parallelAllowed) {
-        m_pluginLoaderMtx.lock();
+    if (m_dspStatName.isNotEmpty()) {
+        Metrics::removeStatistic(m_dspStatName);
+    }
+    if (m_memStatName.isNotEmpty()) {
+        Metrics::removeStatistic(m_memStatName);
+        Metrics::getStatistic<Gauge>("PluginMemory")->decrement(m_memBytes);
+        m_memStatName.clear();
+        m_memBytes = 0;
     }
+    // the deleter of the instance deletes it on the message thread, so releasing it never blocks
     p.reset();
-    if (!parallelAllowed) {
-        m_pluginLoaderMtx.unlock();
+}
+
+bool AGProcessor::getParameterValue(int paramIdx, float& value) {
+    traceScope();
+    // hold a reference to the plugin, so that the parameter stays valid after unlocking
+    std::shared_ptr<AudioPluginInstance> p;
+    AudioProcessorParameter* param = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_pluginMtx);
+        auto it = m_paramIndex.find(paramIdx);
+        if (it == m_paramIndex.end()) {
+            return false;
+        }
+        p = m_plugin;
+        param = it->second;
     }
+    value = param->getValue();
+    return true;
+}
+
+std::vector<int> AGProcessor::getParameterIndexes() {
+    traceScope();
+    std::vector<int> ret;
+    std::lock_guard<std::mutex> lock(m_pluginMtx);
+    for (auto& kv : m_paramIndex) {
+        ret.push_back(kv.first);
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+void AGProcessor::setParameterListener(AudioProcessorParameter::Listener* listener) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_pluginMtx);
+    if (nullptr != m_plugin) {
+        for (auto* param : m_plugin->getParameters()) {
+            if (nullptr != m_paramListener) {
+                param->removeListener(m_paramListener);
+            }
+            if (nullptr != listener) {
+                param->addListener(listener);
+            }
+        }
+    }
+    m_paramListener = listener;
+}
+
+bool AGProcessor::setParameterValue(int paramIdx, float value) {
+    traceScope();
+    std::shared_ptr<AudioPluginInstance> p;
+    AudioProcessorParameter* param = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_pluginMtx);
+        auto it = m_paramIndex.find(paramIdx);
+        if (it == m_paramIndex.end()) {
+            return false;
+        }
+        p = m_plugin;
+        param = it->second;
+    }
+    param->setValue(value);
+    return true;
+}
+
+int64 AGProcessor::getExpectedMemory(const String& id) {
+    std::lock_guard<std::mutex> lock(m_expectedMemoryMtx);
+    auto it = m_expectedMemory.find(id);
+    return it != m_expectedMemory.end() ? it->second : 0;
+}
+
+AGProcessor::DSPStats AGProcessor::getDSPStats() {
+    traceScope();
+    DSPStats stats;
+    if (nullptr != m_dspTime) {
+        auto hist = m_dspTime->get1minHistogram();
+        stats.avg = hist.avg;
+        stats.p99 = hist.nintyNinth;
+        stats.max = hist.max;
+        double budget = m_blockSize * 1000.0 / m_sampleRate;
+        if (budget > 0) {
+            stats.load = hist.avg / budget * 100;
+        }
+    }
+    return stats;
 }
 
 void AGProcessor::processBlockBypassed(AudioBuffer<float>& buffer) {
@@ -267,6 +432,58 @@ void AGProcessor::suspendProcessing(const bool shouldBeSuspended) {
     }
 }
 
+void AGProcessor::hibernate(bool unload) {
+    traceScope();
+    auto p = getPlugin();
+    if (m_hibernated || nullptr == p) {
+        return;
+    }
+    m_hibernatedSuspended = p->isSuspended();
+    if (unload && nullptr == p->getActiveEditor()) {
+        MemoryBlock state;
+        p->getStateInformation(state);
+        m_hibernatedState.reset();
+        {
+            MemoryOutputStream out(m_hibernatedState, false);
+            GZIPCompressorOutputStream gz(out);
+            gz.write(state.getData(), state.getSize());
+        }
+        logln("unloading " << p->getName() << ", state size " << state.getSize() << " bytes, compressed "
+                           << m_hibernatedState.getSize() << " bytes");
+        unload();
+    } else if (!m_hibernatedSuspended) {
+        releaseResources();
+    }
+    m_hibernated = true;
+}
+
+bool AGProcessor::resume(String& err) {
+    traceScope();
+    if (!m_hibernated) {
+        return true;
+    }
+    if (nullptr == getPlugin()) {
+        if (!load(err)) {
+            return false;
+        }
+        if (m_hibernatedState.getSize() > 0) {
+            MemoryInputStream in(m_hibernatedState, false);
+            GZIPDecompressorInputStream gz(in);
+            MemoryBlock state;
+            gz.readIntoMemoryBlock(state);
+            setStateInformation(state.getData(), (int)state.getSize());
+            m_hibernatedState.reset();
+        }
+        if (m_hibernatedSuspended) {
+            suspendProcessing(true);
+        }
+    } else if (!m_hibernatedSuspended) {
+        prepareToPlay(m_chain.getSampleRate(), m_chain.getBlockSize());
+    }
+    m_hibernated = false;
+    return true;
+}
+
 void AGProcessor::updateLatencyBuffers() {
     traceScope();
     logln("updating latency buffers for " << m_lastKnownLatency << " samples");
@@ -308,6 +525,7 @@ void ProcessorChain::prepareToPlay(double sampleRate, int maximumExpectedSamples
     traceScope();
     setRateAndBufferSizeDetails(sampleRate, maximumExpectedSamplesPerBlock);
     std::lock_guard<std::mutex> lock(m_processors_mtx);
+    waitForPipelineNoLock();
     for (auto& proc : m_processors) {
         proc->prepareToPlay(sampleRate, maximumExpectedSamplesPerBlock);
     }
@@ -316,13 +534,80 @@ void ProcessorChain::prepareToPlay(double sampleRate, int maximumExpectedSamples
 void ProcessorChain::releaseResources() {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processors_mtx);
+    waitForPipelineNoLock();
     for (auto& proc : m_processors) {
         proc->releaseResources();
     }
 }
 
+void ProcessorChain::hibernate(bool unload) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_processors_mtx);
+    if (m_hibernated) {
+        return;
+    }
+    waitForPipelineNoLock();
+    for (auto& proc : m_processors) {
+        proc->hibernate(unload);
+    }
+    if (nullptr == m_resumeWorker) {
+        m_resumeWorker = std::make_unique<ChainResumeWorker>(getLogTagSource(), [this] {
+            traceScope();
+            auto resumeTime = TimeStatistic::getDuration("HibernationResume");
+            resume();
+            resumeTime.update();
+        });
+        m_resumeWorker->startThread();
+    }
+    m_hibernated = true;
+    Metrics::getStatistic<Gauge>("HibernatedChains")->increment();
+    logln("chain (" << m_processors.size() << " processors) hibernated");
+}
+
+bool ProcessorChain::resume() {
+    traceScope();
+    // the background resume and the command thread might resume at the same time
+    std::lock_guard<std::mutex> resumeLock(m_resumeMtx);
+    std::vector<std::shared_ptr<AGProcessor>> procs;
+    {
+        std::lock_guard<std::mutex> lock(m_processors_mtx);
+        if (!m_hibernated) {
+            return true;
+        }
+        procs = m_processors;
+    }
+    // reloading the plugins can take long, so the processors are resumed without holding the lock. The chain stays
+    // flagged as hibernated until all are back, so it does not get processed meanwhile.
+    bool success = true;
+    for (auto& proc : procs) {
+        String err;
+        if (!proc->resume(err)) {
+            logln("error: failed to resume processor: " << err);
+            success = false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_processors_mtx);
+    // plugins that could not be loaded again are passed through
+    updateNoLock();
+    // the chain might have been cleared meanwhile
+    if (m_hibernated.exchange(false)) {
+        Metrics::getStatistic<Gauge>("HibernatedChains")->decrement();
+    }
+    logln("chain resumed");
+    return success;
+}
+
+void ProcessorChain::resumeAsync() {
+    traceScope();
+    // the worker exists, once the chain has been hibernated
+    if (m_hibernated) {
+        m_resumeWorker->trigger();
+    }
+}
+
 void ProcessorChain::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMessages) {
     traceScope();
+    m_lastProcessed = Time::getMillisecondCounter();
     auto start_proc = Time::getHighResolutionTicks();
     processBlockReal(buffer, midiMessages);
     auto end_proc = Time::getHighResolutionTicks();
@@ -334,6 +619,7 @@ void ProcessorChain::processBlock(AudioBuffer<float>& buffer, MidiBuffer& midiMe
 
 void ProcessorChain::processBlock(AudioBuffer<double>& buffer, MidiBuffer& midiMessages) {
     traceScope();
+    m_lastProcessed = Time::getMillisecondCounter();
     auto start_proc = Time::getHighResolutionTicks();
     processBlockReal(buffer, midiMessages);
     auto end_proc = Time::getHighResolutionTicks();
@@ -356,8 +642,7 @@ bool ProcessorChain::isBusesLayoutSupported(const BusesLayout& layouts) const {
     return true;
 }
 
-bool ProcessorChain::updateChannels(int channelsIn, int channelsOut) {
-    traceScope();
+AudioProcessor::BusesLayout ProcessorChain::createBusesLayout(int channelsIn, int channelsOut) {
     AudioProcessor::BusesLayout layout;
     if (channelsIn == 1) {
         layout.inputBuses.add(AudioChannelSet::mono());
@@ -369,8 +654,15 @@ bool ProcessorChain::updateChannels(int channelsIn, int channelsOut) {
     } else if (channelsOut == 2) {
         layout.outputBuses.add(AudioChannelSet::stereo());
     }
-    setBusesLayout(layout);
+    return layout;
+}
+
+bool ProcessorChain::updateChannels(int channelsIn, int channelsOut) {
+    traceScope();
+    // plugins get initialized concurrently on the loader workers, they read the layout under the lock
     std::lock_guard<std::mutex> lock(m_processors_mtx);
+    setBusesLayout(createBusesLayout(channelsIn, channelsOut));
+    auto layout = getBusesLayout();
     m_extraChannels = 0;
     for (auto& proc : m_processors) {
         auto p = proc->getPlugin();
@@ -379,19 +671,19 @@ bool ProcessorChain::updateChannels(int channelsIn, int channelsOut) {
         }
         int extraInChannels = 0;
         int extraOutChannels = 0;
-        setProcessorBusesLayout(p, extraInChannels, extraOutChannels);
+        setProcessorBusesLayout(p, layout, extraInChannels, extraOutChannels);
         proc->setExtraChannels(extraInChannels, extraOutChannels);
+        m_extraChannels = jmax(m_extraChannels, extraInChannels, extraOutChannels);
     }
     return true;
 }
 
-void ProcessorChain::setProcessorBusesLayout(std::shared_ptr<AudioPluginInstance> proc, int& extraInChannels,
-                                             int& extraOutChannels) {
+void ProcessorChain::setProcessorBusesLayout(std::shared_ptr<AudioPluginInstance> proc, const BusesLayout& layout,
+                                             int& extraInChannels, int& extraOutChannels) {
     traceScope();
 
-    auto layout = getBusesLayout();
-
-    bool supported = proc->checkBusesLayoutSupported(layout) && proc->setBusesLayout(layout);
+    bool supported = proc->getBusesLayout() == layout ||
+                     (proc->checkBusesLayoutSupported(layout) && proc->setBusesLayout(layout));
 
     if (!supported) {
         logln("standard layout not supported:");
@@ -416,10 +708,7 @@ void ProcessorChain::setProcessorBusesLayout(std::shared_ptr<AudioPluginInstance
             extraOutChannels += procLayout.outputBuses[busIdx].size();
         }
 
-        m_extraChannels = jmax(m_extraChannels, extraInChannels, extraOutChannels);
-
-        logln(extraInChannels << " extra input(s), " << extraOutChannels << " extra output(s) -> " << m_extraChannels
-                              << " extra channel(s) in total");
+        logln(extraInChannels << " extra input(s), " << extraOutChannels << " extra output(s)");
     }
 }
 
@@ -430,9 +719,8 @@ int ProcessorChain::getExtraChannels() {
 }
 
 bool ProcessorChain::initPluginInstance(std::shared_ptr<AudioPluginInstance> inst, int& extraInChannels,
-                                        int& extraOutChannels, String& /*err*/) {
+                                        int& extraOutChannels, String& /*err*/, bool prepared) {
     traceScope();
-    setProcessorBusesLayout(inst, extraInChannels, extraOutChannels);
     AudioProcessor::ProcessingPrecision prec = AudioProcessor::singlePrecision;
     if (isUsingDoublePrecision() && supportsDoublePrecisionProcessing()) {
         if (inst->supportsDoublePrecisionProcessing()) {
@@ -441,13 +729,39 @@ bool ProcessorChain::initPluginInstance(std::shared_ptr<AudioPluginInstance> ins
             logln("host wants double precission but plugin '" << inst->getName() << "' does not support it");
         }
     }
-    inst->setProcessingPrecision(prec);
-    inst->prepareToPlay(getSampleRate(), getBlockSize());
+    // this runs concurrently on the loader workers, the extra channels of the plugin get merged into the chain, when
+    // the processor gets added
+    BusesLayout layout;
+    int chainExtraChannels;
+    {
+        std::lock_guard<std::mutex> lock(m_processors_mtx);
+        layout = getBusesLayout();
+        chainExtraChannels = m_extraChannels;
+    }
+    if (prepared) {
+        // a layout, that the plugin does not support, is kept as it is and handled via extra channels
+        bool layoutMatches = inst->getBusesLayout() == layout || !inst->checkBusesLayoutSupported(layout);
+        if (inst->getSampleRate() != getSampleRate() || inst->getBlockSize() != getBlockSize() ||
+            inst->getProcessingPrecision() != prec || !layoutMatches) {
+            logln("format of warm instance of " << inst->getName() << " differs, preparing it again");
+            inst->releaseResources();
+            prepared = false;
+        }
+    }
+    setProcessorBusesLayout(inst, layout, extraInChannels, extraOutChannels);
+    if (!prepared) {
+        inst->setProcessingPrecision(prec);
+        inst->prepareToPlay(getSampleRate(), getBlockSize());
+    }
     inst->setPlayHead(getPlayHead());
-    if (prec == AudioProcessor::doublePrecision) {
-        preProcessBlocks<double>(inst);
-    } else {
-        preProcessBlocks<float>(inst);
+    if (!prepared) {
+        int channels = jmax(layout.getMainInputChannels(), layout.getMainOutputChannels()) +
+                       jmax(chainExtraChannels, extraInChannels, extraOutChannels);
+        if (prec == AudioProcessor::doublePrecision) {
+            preProcessBlocks<double>(*inst, channels, getBlockSize());
+        } else {
+            preProcessBlocks<float>(*inst, channels, getBlockSize());
+        }
     }
     return true;
 }
@@ -462,6 +776,22 @@ bool ProcessorChain::addPluginProcessor(const String& id, String& err) {
     return false;
 }
 
+void ProcessorChain::loadPluginProcessors(const StringArray& ids, LoadedFn onLoaded) {
+    traceScope();
+    // the plugin loader limits the concurrency per format and vendor
+    for (int i = 0; i < ids.size(); i++) {
+        if (ids[i].isEmpty()) {
+            continue;
+        }
+        auto proc = std::make_shared<AGProcessor>(*this, ids[i], getSampleRate(), getBlockSize());
+        proc->loadAsync([proc, onLoaded, i](bool ok, const String& err) mutable {
+            onLoaded((size_t)i, ok ? proc : nullptr, err);
+            // this runs on a loader worker, the processor must not be destroyed here, if the receiver dropped it
+            MessageManager::callAsync([p = std::move(proc)] {});
+        });
+    }
+}
+
 void ProcessorChain::addProcessor(std::shared_ptr<AGProcessor> processor) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processors_mtx);
@@ -471,15 +801,20 @@ void ProcessorChain::addProcessor(std::shared_ptr<AGProcessor> processor) {
 
 void ProcessorChain::delProcessor(int idx) {
     traceScope();
-    int i = 0;
-    std::lock_guard<std::mutex> lock(m_processors_mtx);
-    for (auto it = m_processors.begin(); it < m_processors.end(); it++) {
-        if (i++ == idx) {
-            m_processors.erase(it);
-            break;
+    // release the processor outside of the lock, the audio thread needs it
+    std::shared_ptr<AGProcessor> removed;
+    {
+        int i = 0;
+        std::lock_guard<std::mutex> lock(m_processors_mtx);
+        for (auto it = m_processors.begin(); it < m_processors.end(); it++) {
+            if (i++ == idx) {
+                removed = *it;
+                m_processors.erase(it);
+                break;
+            }
         }
+        updateNoLock();
     }
-    updateNoLock();
 }
 
 void ProcessorChain::update() {
@@ -490,18 +825,30 @@ void ProcessorChain::update() {
 
 void ProcessorChain::updateNoLock() {
     traceScope();
+    updateStagesNoLock();
     int latency = 0;
     bool supportsDouble = true;
     m_extraChannels = 0;
-    for (auto& proc : m_processors) {
-        auto p = proc->getPlugin();
-        if (nullptr != p) {
-            latency += p->getLatencySamples();
-            if (!p->supportsDoublePrecisionProcessing()) {
-                supportsDouble = false;
+    for (auto& stage : m_stages) {
+        int stageLatency = 0;
+        for (auto& branch : stage.branches) {
+            int branchLatency = 0;
+            for (auto& proc : branch->getProcessors()) {
+                auto p = proc->getPlugin();
+                if (nullptr != p) {
+                    branchLatency += p->getLatencySamples();
+                    if (!p->supportsDoublePrecisionProcessing()) {
+                        supportsDouble = false;
+                    }
+                    m_extraChannels = jmax(m_extraChannels, proc->getExtraInChannels(), proc->getExtraOutChannels());
+                }
             }
-            m_extraChannels = jmax(m_extraChannels, proc->getExtraInChannels(), proc->getExtraOutChannels());
+            stageLatency = jmax(stageLatency, branchLatency);
         }
+        latency += stageLatency;
+    }
+    if (!m_pipeline.empty()) {
+        latency += getBlockSize() * ((int)m_pipeline.size() - 1);
     }
     if (latency != getLatencySamples()) {
         logln("updating latency samples to " << latency);
@@ -519,6 +866,117 @@ void ProcessorChain::updateNoLock() {
     }
 }
 
+void ProcessorChain::updateStagesNoLock() {
+    traceScope();
+    // the pipeline worker might still process a block with the current stages
+    waitForPipelineNoLock();
+    m_stages.clear();
+    size_t maxBranches = 1;
+    for (auto& proc : m_processors) {
+        int group = proc->getParallelGroup();
+        if (m_stages.empty() || group == 0 || m_stages.back().group != group) {
+            m_stages.emplace_back();
+            m_stages.back().group = group;
+        }
+        auto& stage = m_stages.back();
+        int branchId = group > 0 ? proc->getParallelBranch() : 0;
+        ChainBranch* branch = nullptr;
+        for (auto& b : stage.branches) {
+            if (b->getId() == branchId) {
+                branch = b.get();
+                break;
+            }
+        }
+        if (nullptr == branch) {
+            stage.branches.push_back(std::make_unique<ChainBranch>(getLogTagSource(), branchId));
+            branch = stage.branches.back().get();
+        }
+        branch->addProcessor(proc);
+    }
+    for (auto& stage : m_stages) {
+        if (stage.group > 0 && m_dryGroups.count(stage.group) > 0) {
+            stage.branches.push_back(std::make_unique<ChainBranch>(getLogTagSource(), ChainBranch::DRY_BRANCH));
+        }
+        maxBranches = jmax(maxBranches, stage.branches.size());
+    }
+    while (m_branchWorkers.size() < maxBranches - 1) {
+        logln("starting branch worker " << m_branchWorkers.size());
+        auto worker = std::make_unique<ChainBranchWorker>(getLogTagSource());
+        worker->startThread(Thread::realtimeAudioPriority);
+        m_branchWorkers.push_back(std::move(worker));
+    }
+    updatePipelineNoLock();
+}
+
+void ProcessorChain::updatePipelineNoLock() {
+    traceScope();
+    // split the chain into segments with about the same number of processors
+    size_t segments = (size_t)jlimit(0, MAX_PIPELINE_SEGMENTS, getApp()->getServer().getPipelineStages());
+    segments = jmin(segments, m_stages.size());
+    std::vector<size_t> bounds;
+    if (segments > 1) {
+        auto getStageSize = [](const Stage& stage) {
+            size_t size = 0;
+            for (auto& branch : stage.branches) {
+                size += branch->getProcessors().size();
+            }
+            return size;
+        };
+        size_t total = m_processors.size();
+        size_t count = 0;
+        bounds.push_back(0);
+        for (size_t i = 0; i + 1 < m_stages.size() && bounds.size() < segments; i++) {
+            count += getStageSize(m_stages[i]);
+            // every remaining segment needs at least one stage
+            bool mustSplit = m_stages.size() - (i + 1) <= segments - bounds.size();
+            if (mustSplit || count * segments >= total * bounds.size()) {
+                bounds.push_back(i + 1);
+            }
+        }
+        bounds.push_back(m_stages.size());
+    }
+    size_t numSegments = bounds.empty() ? 0 : bounds.size() - 1;
+    if (numSegments != m_pipeline.size()) {
+        // the workers are idle, as the stages are updated after waiting for the pipeline
+        m_pipeline.clear();
+        m_pipelineSlots.reset();
+        m_pipelineNumSlots = 0;
+        m_pipelineSeq = 0;
+        if (numSegments > 1) {
+            logln("pipelined processing enabled with " << (int)numSegments << " segments");
+            m_pipeline.resize(numSegments);
+            for (size_t i = 1; i < numSegments; i++) {
+                m_pipeline[i].worker = std::make_unique<ChainPipelineWorker>(
+                    getLogTagSource(), [this, i](int slot) { processPipelineSlot(i, slot); });
+                m_pipeline[i].worker->startThread(Thread::realtimeAudioPriority);
+            }
+            // one slot per block in flight, one for the next block and one for a late block
+            m_pipelineNumSlots = numSegments + 1;
+            m_pipelineSlots = std::make_unique<PipelineSlot[]>(m_pipelineNumSlots);
+            m_pipelineMisses = Metrics::getStatistic<Meter>("PipelineMiss");
+        } else {
+            logln("pipelined processing disabled");
+        }
+    }
+    for (size_t i = 0; i < m_pipeline.size(); i++) {
+        auto& seg = m_pipeline[i];
+        seg.firstStage = bounds[i];
+        seg.lastStage = bounds[i + 1];
+        if (nullptr == seg.worker) {
+            continue;
+        }
+        size_t maxBranches = 1;
+        for (size_t s = seg.firstStage; s < seg.lastStage; s++) {
+            maxBranches = jmax(maxBranches, m_stages[s].branches.size());
+        }
+        while (seg.branchWorkers.size() < maxBranches - 1) {
+            auto worker = std::make_unique<ChainBranchWorker>(getLogTagSource());
+            worker->startThread(Thread::realtimeAudioPriority);
+            seg.branchWorkers.push_back(std::move(worker));
+        }
+    }
+}
+
 std::shared_ptr<AGProcessor> ProcessorChain::getProcessor(int index) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processors_mtx);
@@ -533,20 +991,39 @@ void ProcessorChain::exchangeProcessors(int idxA, int idxB) {
     std::lock_guard<std::mutex> lock(m_processors_mtx);
     if (idxA > -1 && as<size_t>(idxA) < m_processors.size() && idxB > -1 && as<size_t>(idxB) < m_processors.size()) {
         std::swap(m_processors[as<size_t>(idxA)], m_processors[as<size_t>(idxB)]);
+        updateNoLock();
+    }
+}
+
+void ProcessorChain::setParallelBranch(int idx, int group, int branch) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_processors_mtx);
+    if (idx > -1 && as<size_t>(idx) < m_processors.size()) {
+        logln("moving processor " << idx << " to parallel group " << group << ", branch " << branch);
+        m_processors[as<size_t>(idx)]->setParallelBranch(group, branch);
+        updateNoLock();
     }
 }
 
+void ProcessorChain::setParallelDry(int group, bool dry) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_processors_mtx);
+    logln((dry ? "adding dry branch to" : "removing dry branch from") << " parallel group " << group);
+    if (dry) {
+        m_dryGroups.insert(group);
+    } else {
+        m_dryGroups.erase(group);
+    }
+    updateNoLock();
+}
+
 float ProcessorChain::getParameterValue(int idx, int paramIdx) {
     traceScope();
     std::lock_guard<std::mutex> lock(m_processors_mtx);
     if (idx > -1 && as<size_t>(idx) < m_processors.size()) {
-        auto p = m_processors[as<size_t>(idx)]->getPlugin();
-        if (nullptr != p) {
-            for (auto& param : p->getParameters()) {
-                if (paramIdx == param->getParameterIndex()) {
-                    return param->getValue();
-                }
-            }
+        float value;
+        if (m_processors[as<size_t>(idx)]->getParameterValue(paramIdx, value)) {
+            return value;
         }
     }
     return 0;
@@ -555,8 +1032,17 @@ float ProcessorChain::getParameterValue(int idx, int paramIdx) {
 void ProcessorChain::clear() {
     traceScope();
     releaseResources();
-    std::lock_guard<std::mutex> lock(m_processors_mtx);
-    m_processors.clear();
+    // release the processors outside of the lock
+    std::vector<std::shared_ptr<AGProcessor>> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_processors_mtx);
+        removed.swap(m_processors);
+        m_dryGroups.clear();
+        updateStagesNoLock();
+        if (m_hibernated.exchange(false)) {
+            Metrics::getStatistic<Gauge>("HibernatedChains")->decrement();
+        }
+    }
 }
 
 String ProcessorChain::toString() {
@@ -575,6 +1061,9 @@ String ProcessorChain::toString() {
         } else {
             ret << proc->getName();
         }
+        if (proc->getParallelGroup() > 0) {
+            ret << " [" << proc->getParallelGroup() << "/" << proc->getParallelBranch() << "]";
+        }
     }
     return ret;
 }
@@ -9,9 +9,16 @@
 #define ProcessorChain_hpp
 
 #include <JuceHeader.h>
+#include <unordered_map>
+#include <set>
+
+JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE("-Wzero-as-null-pointer-constant")
+#include <boost/lockfree/spsc_queue.hpp>
+JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 
 #include "Utils.hpp"
 #include "Defaults.hpp"
+#include "Metrics.hpp"
 
 namespace e47 {
 
@@ -68,6 +75,8 @@ class AGProcessor : public LogTagDelegate {
                                                            int blockSize, String& err);
 
     bool load(String& err);
+    // Loads the plugin on the plugin loader and returns right away, onDone gets called when the load has finished
+    void loadAsync(std::function<void(bool, const String&)> onDone);
     void unload();
 
     template <typename T>
@@ -75,7 +84,8 @@ class AGProcessor : public LogTagDelegate {
         traceScope();
         auto p = getPlugin();
         if (nullptr != p) {
-            if (!p->isSuspended()) {
+            TimeStatistic::Duration duration(m_dspTime);
+            if (!p->isSuspended() && !m_governorBypassed) {
                 p->processBlock(buffer, midiMessages);
             } else {
                 if (m_lastKnownLatency > 0) {
@@ -181,9 +191,23 @@ class AGProcessor : public LogTagDelegate {
         auto p = getPlugin();
         if (nullptr != p) {
             p->getStateInformation(destData);
+        } else if (m_hibernated && m_hibernatedState.getSize() > 0) {
+            MemoryInputStream in(m_hibernatedState, false);
+            GZIPDecompressorInputStream gz(in);
+            gz.readIntoMemoryBlock(destData);
         }
     }
 
+    // Parameter access by parameter index, the lookup uses an index, that is built when loading the plugin
+    bool getParameterValue(int paramIdx, float& value);
+    bool setParameterValue(int paramIdx, float value);
+    // The parameter indexes of the loaded plugin, sorted
+    std::vector<int> getParameterIndexes();
+
+    // Attaches a listener to the parameters of the plugin. The listener gets detached when the plugin is unloaded and
+    // attached again, when hibernation loads the plugin again. Pass nullptr to detach it.
+    void setParameterListener(AudioProcessorParameter::Listener* listener);
+
     void setStateInformation(const void* data, int sizeInBytes) {
         traceScope();
         auto p = getPlugin();
@@ -195,6 +219,43 @@ class AGProcessor : public LogTagDelegate {
     void suspendProcessing(const bool shouldBeSuspended);
     void updateLatencyBuffers();
 
+    // Bypass by the overload governor. This is independent of the bypass by the client, the plugin stays prepared, so
+    // it can be restored without any delay.
+    void setGovernorBypassed(bool b) { m_governorBypassed = b; }
+    bool isGovernorBypassed() const { return m_governorBypassed; }
+
+    // Releases the plugin resources. If unload is set, the plugin state gets stored as a compressed blob and the
+    // plugin instance is deleted. Plugins with an open editor are never unloaded.
+    void hibernate(bool unload);
+    bool resume(String& err);
+    bool isHibernated() const { return m_hibernated; }
+
+    struct DSPStats {
+        double load = 0;  // average processing time in percent of the time budget of a block
+        double avg = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    // Processing time statistics of the last minute
+    DSPStats getDSPStats();
+
+    // The per plugin processing time statistics are registered in Metrics with a name in the format
+    // "<DSP_STAT_PREFIX><client>|<plugin name>|<processor>"
+    static constexpr const char* DSP_STAT_PREFIX = "dsp|";
+
+    // Approximate memory of the plugin instance, measured as the growth of the resident set size of the server while
+    // loading the plugin. For pooled instances the growth has been measured by the pool, when it created the instance.
+    // Concurrent loads can blur the numbers.
+    int64 getMemoryBytes() const { return m_memBytes; }
+
+    // The per plugin memory is registered in Metrics as a Gauge with a name in the format
+    // "<MEM_STAT_PREFIX><client>|<plugin name>|<processor>", the sum of all plugins as "PluginMemory"
+    static constexpr const char* MEM_STAT_PREFIX = "mem|";
+
+    // Returns the memory, that the last fresh instance of the given plugin needed or 0 if unknown
+    static int64 getExpectedMemory(const String& id);
+
     int getExtraInChannels() const { return m_extraInChannels; }
     int getExtraOutChannels() const { return m_extraOutChannels; }
     void setExtraChannels(int in, int out) {
@@ -202,13 +263,23 @@ class AGProcessor : public LogTagDelegate {
         m_extraOutChannels = out;
     }
 
+    // Consecutive processors with the same group (> 0) form a parallel section, processors with the same branch
+    // within a section are processed serially. Group 0 means serial processing.
+    int getParallelGroup() const { return m_parallelGroup; }
+    int getParallelBranch() const { return m_parallelBranch; }
+    void setParallelBranch(int group, int branch) {
+        m_parallelGroup = jmax(0, group);
+        m_parallelBranch = jmax(0, branch);
+    }
+
   private:
     ProcessorChain& m_chain;
     String m_id;
     double m_sampleRate;
     int m_blockSize;
-    static std::mutex m_pluginLoaderMtx;
     std::shared_ptr<AudioPluginInstance> m_plugin;
+    std::unordered_map<int, AudioProcessorParameter*> m_paramIndex;
+    AudioProcessorParameter::Listener* m_paramListener = nullptr;
     std::mutex m_pluginMtx;
     int m_additionalScreenSpace = 0;
     bool m_fullscreen = false;
@@ -218,6 +289,265 @@ class AGProcessor : public LogTagDelegate {
     Array<Array<float>> m_bypassBufferF;
     Array<Array<double>> m_bypassBufferD;
     int m_lastKnownLatency = 0;
+    std::shared_ptr<TimeStatistic> m_dspTime;
+    String m_dspStatName;
+    int64 m_memBytes = 0;
+    String m_memStatName;
+    static std::unordered_map<String, int64> m_expectedMemory;
+    static std::mutex m_expectedMemoryMtx;
+    int m_parallelGroup = 0;
+    int m_parallelBranch = 0;
+    bool m_hibernated = false;
+    bool m_hibernatedSuspended = false;
+    MemoryBlock m_hibernatedState;
+    std::atomic_bool m_governorBypassed{false};
+
+    void setLoaded(std::shared_ptr<AudioPluginInstance> p, int64 memBytes);
+};
+
+// A branch of a parallel section. A branch without processors passes its input through (dry branch).
+class ChainBranch : public LogTagDelegate {
+  public:
+    static constexpr int DRY_BRANCH = -1;
+
+    ChainBranch(const LogTag* tag, int id) : LogTagDelegate(tag), m_id(id) {}
+
+    int getId() const { return m_id; }
+    void addProcessor(std::shared_ptr<AGProcessor> proc) { m_processors.push_back(proc); }
+    const std::vector<std::shared_ptr<AGProcessor>>& getProcessors() const { return m_processors; }
+
+    // Process the branch in place and return the latency of the branch without compensation
+    template <typename T>
+    int processBlock(AudioBuffer<T>& buffer, MidiBuffer& midiMessages) {
+        traceScope();
+        int latency = 0;
+        for (auto& proc : m_processors) {
+            if (proc->processBlock(buffer, midiMessages)) {
+                latency += proc->getLatencySamples();
+            }
+        }
+        compensate(buffer, getDelayBuffer<T>());
+        m_latency = latency;
+        return latency;
+    }
+
+    // Copy the input of a parallel section into the branch buffer, to be processed by a branch worker
+    template <typename T>
+    void setInput(const AudioBuffer<T>& buffer, const MidiBuffer& midiMessages) {
+        traceScope();
+        getBuffer<T>().makeCopyOf(buffer, true);
+        m_midi.clear();
+        m_midi.addEvents(midiMessages, 0, -1, 0);
+        m_isDouble = std::is_same<T, double>::value;
+    }
+
+    void processInput() {
+        traceScope();
+        if (m_isDouble) {
+            processBlock(m_bufferD, m_midi);
+        } else {
+            processBlock(m_bufferF, m_midi);
+        }
+    }
+
+    // Sum the branch audio output into the given buffer. The midi output of a parallel section is taken from the
+    // first branch only, as every branch gets a copy of the input events.
+    template <typename T>
+    void addOutputTo(AudioBuffer<T>& buffer) {
+        traceScope();
+        auto& src = getBuffer<T>();
+        int channels = jmin(buffer.getNumChannels(), src.getNumChannels());
+        int samples = jmin(buffer.getNumSamples(), src.getNumSamples());
+        for (int c = 0; c < channels; c++) {
+            buffer.addFrom(c, 0, src, c, 0, samples);
+        }
+    }
+
+    int getLatencySamples() const { return m_latency; }
+    void setCompensation(int samples) { m_compensation = jmax(0, samples); }
+
+  private:
+    int m_id;
+    std::vector<std::shared_ptr<AGProcessor>> m_processors;
+    AudioBuffer<float> m_bufferF;
+    AudioBuffer<double> m_bufferD;
+    MidiBuffer m_midi;
+    bool m_isDouble = false;
+    int m_latency = 0;
+
+    // Delay line to align the branch to the branch with the highest latency in a parallel section
+    int m_compensation = 0;
+    AudioBuffer<float> m_delayF;
+    AudioBuffer<double> m_delayD;
+    int m_delayPos = 0;
+
+    template <typename T>
+    AudioBuffer<T>& getBuffer();
+    template <typename T>
+    AudioBuffer<T>& getDelayBuffer();
+
+    template <typename T>
+    void compensate(AudioBuffer<T>& buffer, AudioBuffer<T>& delay) {
+        if (m_compensation == 0) {
+            return;
+        }
+        if (delay.getNumSamples() != m_compensation || delay.getNumChannels() < buffer.getNumChannels()) {
+            logln("updating branch " << m_id << " latency compensation to " << m_compensation << " samples");
+            delay.setSize(buffer.getNumChannels(), m_compensation);
+            delay.clear();
+            m_delayPos = 0;
+        }
+        int pos = m_delayPos;
+        for (int c = 0; c < buffer.getNumChannels(); c++) {
+            auto* data = buffer.getWritePointer(c);
+            auto* line = delay.getWritePointer(c);
+            pos = m_delayPos;
+            for (int s = 0; s < buffer.getNumSamples(); s++) {
+                std::swap(data[s], line[pos]);
+                if (++pos == m_compensation) {
+                    pos = 0;
+                }
+            }
+        }
+        m_delayPos = pos;
+    }
+};
+
+template <>
+inline AudioBuffer<float>& ChainBranch::getBuffer() {
+    return m_bufferF;
+}
+template <>
+inline AudioBuffer<double>& ChainBranch::getBuffer() {
+    return m_bufferD;
+}
+template <>
+inline AudioBuffer<float>& ChainBranch::getDelayBuffer() {
+    return m_delayF;
+}
+template <>
+inline AudioBuffer<double>& ChainBranch::getDelayBuffer() {
+    return m_delayD;
+}
+
+class ChainBranchWorker : public Thread, public LogTagDelegate {
+  public:
+    ChainBranchWorker(const LogTag* tag) : Thread("ChainBranchWorker"), LogTagDelegate(tag) {}
+    ~ChainBranchWorker() override {
+        traceScope();
+        signalThreadShouldExit();
+        m_startEvent.signal();
+        waitForThreadAndLog(getLogTagSource(), this);
+    }
+
+    void run() override {
+        traceScope();
+        while (!currentThreadShouldExit()) {
+            if (m_startEvent.wait(100) && !currentThreadShouldExit() && nullptr != m_branch) {
+                m_branch->processInput();
+                m_doneEvent.signal();
+            }
+        }
+    }
+
+    void start(ChainBranch* branch) {
+        m_branch = branch;
+        m_startEvent.signal();
+    }
+
+    void wait() { m_doneEvent.wait(-1); }
+
+  private:
+    ChainBranch* m_branch = nullptr;
+    WaitableEvent m_startEvent, m_doneEvent;
+};
+
+// Processes a segment of a pipelined chain. Buffer slots are handed over via a lock-free queue, the processing
+// function passes a slot on to the worker of the next segment.
+class ChainPipelineWorker : public Thread, public LogTagDelegate {
+  public:
+    using ProcessFn = std::function<void(int)>;
+
+    ChainPipelineWorker(const LogTag* tag, ProcessFn fn)
+        : Thread("ChainPipelineWorker"), LogTagDelegate(tag), m_processFn(fn) {}
+
+    ~ChainPipelineWorker() override {
+        traceScope();
+        signalThreadShouldExit();
+        m_startEvent.signal();
+        waitForThreadAndLog(getLogTagSource(), this);
+    }
+
+    void run() override {
+        traceScope();
+        while (!currentThreadShouldExit()) {
+            int slot;
+            if (m_slotsIn.pop(slot)) {
+                m_processFn(slot);
+                m_pending--;
+                m_doneEvent.signal();
+            } else {
+                m_startEvent.wait(100);
+            }
+        }
+    }
+
+    bool push(int slot) {
+        if (!m_slotsIn.push(slot)) {
+            return false;
+        }
+        m_pending++;
+        m_startEvent.signal();
+        return true;
+    }
+
+    bool isPending() const { return m_pending > 0; }
+
+    // Wait until the slots in flight have been processed
+    void waitForPending() {
+        while (m_pending > 0 && isThreadRunning()) {
+            m_doneEvent.wait(10);
+        }
+    }
+
+    static constexpr size_t MAX_SLOTS = 16;
+
+  private:
+    ProcessFn m_processFn;
+    boost::lockfree::spsc_queue<int, boost::lockfree::capacity<MAX_SLOTS>> m_slotsIn;
+    std::atomic_int m_pending{0};
+    WaitableEvent m_startEvent, m_doneEvent;
+};
+
+// Resumes a hibernated chain in the background, so that the audio thread never waits for plugins to be loaded again
+class ChainResumeWorker : public Thread, public LogTagDelegate {
+  public:
+    using ResumeFn = std::function<void()>;
+
+    ChainResumeWorker(const LogTag* tag, ResumeFn fn)
+        : Thread("ChainResumeWorker"), LogTagDelegate(tag), m_resumeFn(fn) {}
+
+    ~ChainResumeWorker() override {
+        traceScope();
+        signalThreadShouldExit();
+        m_startEvent.signal();
+        waitForThreadAndLog(getLogTagSource(), this);
+    }
+
+    void run() override {
+        traceScope();
+        while (!currentThreadShouldExit()) {
+            if (m_startEvent.wait(100) && !currentThreadShouldExit()) {
+                m_resumeFn();
+            }
+        }
+    }
+
+    void trigger() { m_startEvent.signal(); }
+
+  private:
+    ResumeFn m_resumeFn;
+    WaitableEvent m_startEvent;
 };
 
 class ProcessorChain : public AudioProcessor, public LogTagDelegate {
@@ -258,8 +588,9 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     bool updateChannels(int channelsIn, int channelsOut);
-    void setProcessorBusesLayout(std::shared_ptr<AudioPluginInstance> proc, int& extraInChannels,
-                                 int& extraOutChannels);
+    // Applies the given layout to the plugin or calculates the extra channels it needs, if it does not support it
+    void setProcessorBusesLayout(std::shared_ptr<AudioPluginInstance> proc, const BusesLayout& layout,
+                                 int& extraInChannels, int& extraOutChannels);
     int getExtraChannels();
 
     bool acceptsMidi() const override { return false; }
@@ -274,18 +605,61 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     void getStateInformation(juce::MemoryBlock& /* destData */) override {}
     void setStateInformation(const void* /* data */, int /* sizeInBytes */) override {}
 
+    // Prepares a plugin instance for the chain. Instances from the plugin pool are prepared already, they are only
+    // prepared again, if the format of the chain differs.
     bool initPluginInstance(std::shared_ptr<AudioPluginInstance> processor, int& extraInChannels, int& extraOutChannels,
-                            String& err);
+                            String& err, bool prepared = false);
+
+    static AudioProcessor::BusesLayout createBusesLayout(int channelsIn, int channelsOut);
+
+    // Let a freshly prepared plugin instance process some silence, as some plugins need a few blocks to settle
+    template <typename T>
+    static void preProcessBlocks(AudioPluginInstance& inst, int channels, int blockSize) {
+        MidiBuffer midi;
+        AudioBuffer<T> buf(channels, blockSize);
+        buf.clear();
+        int samplesProcessed = 0;
+        do {
+            inst.processBlock(buf, midi);
+            samplesProcessed += blockSize;
+        } while (samplesProcessed < 8192);
+    }
     bool addPluginProcessor(const String& id, String& err);
+
+    // Called with the index of the ID and the processor or nullptr and an error, when a load has finished
+    using LoadedFn = std::function<void(size_t, std::shared_ptr<AGProcessor>, const String&)>;
+
+    // Loads processors for the given plugins concurrently on the plugin loader without adding them and returns right
+    // away. onLoaded gets called for every non empty ID, as soon as its load has finished.
+    void loadPluginProcessors(const StringArray& ids, LoadedFn onLoaded);
     void addProcessor(std::shared_ptr<AGProcessor> processor);
     size_t getSize() const { return m_processors.size(); }
     std::shared_ptr<AGProcessor> getProcessor(int index);
 
     void delProcessor(int idx);
     void exchangeProcessors(int idxA, int idxB);
+    void setParallelBranch(int idx, int group, int branch);
+
+    // Adds an unprocessed branch to a parallel group, that is summed up with the other branches
+    void setParallelDry(int group, bool dry);
+
+    // Returns true if the chain has been processing audio recently
+    bool isProcessing() const {
+        auto last = m_lastProcessed.load();
+        return last > 0 && Time::getMillisecondCounter() - last < 1000;
+    }
 
     float getParameterValue(int idx, int paramIdx);
 
+    // Hibernation of an idle chain, see AGProcessor::hibernate
+    void hibernate(bool unload);
+    bool resume();
+    bool isHibernated() const { return m_hibernated; }
+
+    // Resumes the chain in the background. The chain stays hibernated and should not be processed until the resume
+    // has finished. This is safe to be called from the audio thread.
+    void resumeAsync();
+
     void update();
 
     void clear();
@@ -298,18 +672,68 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
 
     std::atomic_bool m_supportsDoublePrecission{true};
     std::atomic<double> m_tailSecs{0.0};
+    std::atomic_uint32_t m_lastProcessed{0};
+    std::atomic_bool m_hibernated{false};
+    std::mutex m_resumeMtx;
 
     int m_extraChannels = 0;
 
+    // Parallel groups with a dry branch
+    std::set<int> m_dryGroups;
+
+    // The chain is split into stages, a stage is either a serial list of processors (one branch) or a parallel
+    // section, where all branches get the same input and the outputs get summed up
+    struct Stage {
+        int group = 0;
+        std::vector<std::unique_ptr<ChainBranch>> branches;
+    };
+    std::vector<Stage> m_stages;
+    using BranchWorkers = std::vector<std::unique_ptr<ChainBranchWorker>>;
+    BranchWorkers m_branchWorkers;
+
+    // Pipelined processing: the stages are split into segments, the first segment is processed by the audio thread,
+    // every further segment by its own pipeline worker. A block passes one segment per block period, so the result
+    // of a block is picked up by the audio thread (number of segments - 1) blocks later. The slot of a block is
+    // selected by its sequence number.
+    struct PipelineSlot {
+        AudioBuffer<float> bufferF;
+        AudioBuffer<double> bufferD;
+        MidiBuffer midi;
+        bool isDouble = false;
+        int latency = 0;
+        int64 seq = -1;
+        bool busy = false;
+        std::atomic_bool done{false};
+    };
+    struct PipelineSegment {
+        size_t firstStage = 0;
+        size_t lastStage = 0;
+        // nullptr for the first segment
+        std::unique_ptr<ChainPipelineWorker> worker;
+        BranchWorkers branchWorkers;
+    };
+    std::vector<PipelineSegment> m_pipeline;
+    static constexpr int MAX_PIPELINE_SEGMENTS = 8;
+    std::unique_ptr<PipelineSlot[]> m_pipelineSlots;
+    size_t m_pipelineNumSlots = 0;
+    int64 m_pipelineSeq = 0;
+    WaitableEvent m_pipelineDoneEvent;
+    std::shared_ptr<Meter> m_pipelineMisses;
+
+    // Created with the first hibernation, declared last to be stopped before the other members get destroyed
+    std::unique_ptr<ChainResumeWorker> m_resumeWorker;
+
     template <typename T>
     void processBlockReal(AudioBuffer<T>& buffer, MidiBuffer& midiMessages) {
         traceScope();
         int latency = 0;
         std::lock_guard<std::mutex> lock(m_processors_mtx);
-        for (auto& proc : m_processors) {
-            if (proc->processBlock(buffer, midiMessages)) {
-                latency += proc->getLatencySamples();
-            }
+        if (!m_pipeline.empty()) {
+            // the pipeline results have to be picked up within the time of the block
+            auto deadline = Time::getMillisecondCounterHiRes() + buffer.getNumSamples() * 1000.0 / getSampleRate();
+            latency = processPipelined(buffer, midiMessages, deadline);
+        } else {
+            latency = processStages(buffer, midiMessages, 0, m_stages.size(), m_branchWorkers);
         }
         if (latency != getLatencySamples()) {
             logln("updating latency samples to " << latency);
@@ -318,20 +742,142 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     }
 
     template <typename T>
-    void preProcessBlocks(std::shared_ptr<AudioPluginInstance> inst) {
+    int processStages(AudioBuffer<T>& buffer, MidiBuffer& midiMessages, size_t first, size_t last,
+                      BranchWorkers& workers) {
         traceScope();
-        MidiBuffer midi;
-        int channels = jmax(getMainBusNumInputChannels(), getMainBusNumOutputChannels()) + m_extraChannels;
-        AudioBuffer<T> buf(channels, getBlockSize());
-        buf.clear();
-        int samplesProcessed = 0;
-        do {
-            inst->processBlock(buf, midi);
-            samplesProcessed += getBlockSize();
-        } while (samplesProcessed < 8192);
+        int latency = 0;
+        for (size_t i = first; i < last && i < m_stages.size(); i++) {
+            auto& stage = m_stages[i];
+            if (stage.branches.size() == 1) {
+                latency += stage.branches[0]->processBlock(buffer, midiMessages);
+            } else {
+                latency += processParallel(stage, buffer, midiMessages, workers);
+            }
+        }
+        return latency;
+    }
+
+    template <typename T>
+    int processPipelined(AudioBuffer<T>& buffer, MidiBuffer& midiMessages, double deadlineMs) {
+        traceScope();
+        auto& first = m_pipeline[0];
+        int latency = processStages(buffer, midiMessages, first.firstStage, first.lastStage, m_branchWorkers);
+        auto depth = (int64)m_pipeline.size() - 1;
+        auto seq = m_pipelineSeq++;
+
+        // hand the block over to the second segment
+        auto& next = m_pipelineSlots[(size_t)seq % m_pipelineNumSlots];
+        if (next.busy && next.done) {
+            // the late result of an older block, that has been replaced by silence already
+            next.busy = false;
+        }
+        if (!next.busy) {
+            getSlotBuffer<T>(next).makeCopyOf(buffer, true);
+            next.midi.clear();
+            next.midi.addEvents(midiMessages, 0, -1, 0);
+            next.isDouble = std::is_same<T, double>::value;
+            next.latency = 0;
+            next.seq = seq;
+            next.done = false;
+            next.busy = m_pipeline[1].worker->push((int)((size_t)seq % m_pipelineNumSlots));
+        }
+        midiMessages.clear();
+
+        // pick up the result of the block, that entered the pipeline depth blocks ago
+        auto doneSeq = seq - depth;
+        if (doneSeq < 0) {
+            buffer.clear();
+            return getLatencySamples();
+        }
+        auto& done = m_pipelineSlots[(size_t)doneSeq % m_pipelineNumSlots];
+        if (!done.busy || done.seq != doneSeq) {
+            // the block did not enter the pipeline, as all slots have been busy
+            buffer.clear();
+            return getLatencySamples();
+        }
+        while (!done.done) {
+            auto now = Time::getMillisecondCounterHiRes();
+            if (now >= deadlineMs) {
+                break;
+            }
+            m_pipelineDoneEvent.wait(jmax(1, (int)(deadlineMs - now)));
+        }
+        if (!done.done) {
+            // output silence instead of blocking the audio thread, the slot gets freed when it is done
+            m_pipelineMisses->increment();
+            buffer.clear();
+            return getLatencySamples();
+        }
+        done.busy = false;
+        if (done.isDouble == std::is_same<T, double>::value) {
+            auto& src = getSlotBuffer<T>(done);
+            int channels = jmin(buffer.getNumChannels(), src.getNumChannels());
+            int samples = jmin(buffer.getNumSamples(), src.getNumSamples());
+            buffer.clear();
+            for (int c = 0; c < channels; c++) {
+                buffer.copyFrom(c, 0, src, c, 0, samples);
+            }
+            midiMessages.addEvents(done.midi, 0, -1, 0);
+            latency += done.latency;
+        } else {
+            buffer.clear();
+        }
+        return latency + (int)depth * buffer.getNumSamples();
+    }
+
+    void processPipelineSlot(size_t segment, int slot) {
+        traceScope();
+        auto& seg = m_pipeline[segment];
+        auto& s = m_pipelineSlots[(size_t)slot];
+        if (s.isDouble) {
+            s.latency += processStages(s.bufferD, s.midi, seg.firstStage, seg.lastStage, seg.branchWorkers);
+        } else {
+            s.latency += processStages(s.bufferF, s.midi, seg.firstStage, seg.lastStage, seg.branchWorkers);
+        }
+        if (segment + 1 < m_pipeline.size()) {
+            m_pipeline[segment + 1].worker->push(slot);
+        } else {
+            s.done = true;
+            m_pipelineDoneEvent.signal();
+        }
+    }
+
+    template <typename T>
+    AudioBuffer<T>& getSlotBuffer(PipelineSlot& slot);
+
+    void updatePipelineNoLock();
+    void waitForPipelineNoLock() {
+        // a slot moves from segment to segment, so the workers have to be checked in order
+        for (auto& seg : m_pipeline) {
+            if (nullptr != seg.worker) {
+                seg.worker->waitForPending();
+            }
+        }
+    }
+
+    template <typename T>
+    int processParallel(Stage& stage, AudioBuffer<T>& buffer, MidiBuffer& midiMessages, BranchWorkers& workers) {
+        traceScope();
+        // hand all but the first branch over to the branch workers, the first branch is processed on the calling
+        // thread directly in the chain buffer
+        for (size_t i = 1; i < stage.branches.size(); i++) {
+            stage.branches[i]->setInput(buffer, midiMessages);
+            workers[i - 1]->start(stage.branches[i].get());
+        }
+        int latency = stage.branches[0]->processBlock(buffer, midiMessages);
+        for (size_t i = 1; i < stage.branches.size(); i++) {
+            workers[i - 1]->wait();
+            stage.branches[i]->addOutputTo(buffer);
+            latency = jmax(latency, stage.branches[i]->getLatencySamples());
+        }
+        for (auto& branch : stage.branches) {
+            branch->setCompensation(latency - branch->getLatencySamples());
+        }
+        return latency;
     }
 
     void updateNoLock();
+    void updateStagesNoLock();
 
     void printBusesLayout(const AudioProcessor::BusesLayout& l) {
         logln("input buses: " << l.inputBuses.size());
@@ -351,6 +897,15 @@ class ProcessorChain : public AudioProcessor, public LogTagDelegate {
     }
 };
 
+template <>
+inline AudioBuffer<float>& ProcessorChain::getSlotBuffer(PipelineSlot& slot) {
+    return slot.bufferF;
+}
+template <>
+inline AudioBuffer<double>& ProcessorChain::getSlotBuffer(PipelineSlot& slot) {
+    return slot.bufferD;
+}
+
 }  // namespace e47
 
 #endif /* ProcessorChain_hpp */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SandboxHost.hpp"
+#include "App.hpp"
+#include "Server.hpp"
+#include "NumberConversion.hpp"
+
+namespace e47 {
+
+std::atomic_uint32_t SandboxHost::count{0};
+std::atomic_uint32_t SandboxHost::runCount{0};
+
+SandboxHost::SandboxHost(StreamingSocket* clnt) : Thread("SandboxHost"), LogTag("sandbox"), m_client(clnt) {
+    traceScope();
+    count++;
+}
+
+SandboxHost::~SandboxHost() {
+    traceScope();
+    shutdown();
+    waitForThreadAndLog(this, this);
+    count--;
+}
+
+void SandboxHost::run() {
+    traceScope();
+    runCount++;
+    if (startSandbox()) {
+        logln("relaying client " << m_client->getHostName() << " to sandbox process");
+        std::thread back([this] { relay(m_sandbox.get(), m_client.get()); });
+        relay(m_client.get(), m_sandbox.get());
+        back.join();
+    }
+    stopSandbox();
+    runCount--;
+}
+
+void SandboxHost::shutdown() {
+    traceScope();
+    signalThreadShouldExit();
+    if (nullptr != m_client && m_client->isConnected()) {
+        m_client->close();
+    }
+}
+
+bool SandboxHost::startSandbox() {
+    traceScope();
+    if (!m_listener.createListener(0, "127.0.0.1")) {
+        logln("error: failed to create sandbox listener");
+        return false;
+    }
+    StringArray args;
+    args.add(File::getSpecialLocation(File::currentExecutableFile).getFullPathName());
+    args.add("-sandbox");
+    args.add(String(m_listener.getBoundPort()));
+    args.add("-clienthost");
+    args.add(m_client->getHostName());
+    args.add("-id");
+    args.add(String(getApp()->getServer().getId()));
+    if (!m_proc.start(args, 0)) {
+        logln("error: failed to start sandbox process");
+        return false;
+    }
+    // the sandbox has to load the plugin list before it connects
+    int waited = 0;
+    while (m_listener.waitUntilReady(true, 100) == 0) {
+        waited += 100;
+        if (threadShouldExit() || !m_proc.isRunning() || waited > 30000) {
+            logln("error: sandbox process did not connect");
+            return false;
+        }
+    }
+    m_sandbox.reset(m_listener.waitForNextConnection());
+    m_listener.close();
+    return nullptr != m_sandbox;
+}
+
+void SandboxHost::relay(StreamingSocket* from, StreamingSocket* to) {
+    traceScope();
+    char buf[8192];
+    while (!threadShouldExit() && from->isConnected() && to->isConnected()) {
+        int ready = from->waitUntilReady(true, 100);
+        if (ready < 0) {
+            break;
+        }
+        if (ready > 0) {
+            int len = from->read(buf, sizeof(buf), false);
+            if (len <= 0 || to->write(buf, len) != len) {
+                break;
+            }
+        }
+    }
+    // closing both ends terminates the other direction as well
+    from->close();
+    to->close();
+}
+
+void SandboxHost::stopSandbox() {
+    traceScope();
+    if (nullptr != m_sandbox && m_sandbox->isConnected()) {
+        m_sandbox->close();
+    }
+    if (m_client->isConnected()) {
+        m_client->close();
+    }
+    m_listener.close();
+    if (m_proc.isRunning()) {
+        // the sandbox terminates, when its client disconnects
+        if (!m_proc.waitForProcessToFinish(5000)) {
+            logln("error: sandbox process did not terminate, killing it");
+            m_proc.kill();
+            return;
+        }
+    }
+    auto ec = m_proc.getExitCode();
+    if (ec != 0) {
+        logln("error: sandbox process failed with exit code " << as<int>(ec));
+    }
+}
+
+}  // namespace e47
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SandboxHost_hpp
+#define SandboxHost_hpp
+
+#include <JuceHeader.h>
+
+#include "Utils.hpp"
+
+namespace e47 {
+
+/*
+ * Hosts the chain of a client in a separate process. The sandbox process runs a regular worker for the client, that
+ * connects back to the client for audio and screen data directly. The command connection of the client is relayed
+ * to the sandbox via a loopback connection. If the sandbox crashes, only the connection of its client gets closed.
+ *
+ * Everything, that is shared between the clients of a server, lives in the process of the respective client. So
+ * shared buses and sidechains can't connect chains of different clients, and the memory budget and the overload
+ * governor only see the chain of their own sandbox.
+ */
+class SandboxHost : public Thread, public LogTag {
+  public:
+    static std::atomic_uint32_t count;
+    static std::atomic_uint32_t runCount;
+
+    SandboxHost(StreamingSocket* clnt);
+    ~SandboxHost() override;
+    void run() override;
+
+    void shutdown();
+
+  private:
+    std::unique_ptr<StreamingSocket> m_client;
+    std::unique_ptr<StreamingSocket> m_sandbox;
+    StreamingSocket m_listener;
+    ChildProcess m_proc;
+
+    bool startSandbox();
+    void relay(StreamingSocket* from, StreamingSocket* to);
+    void stopSandbox();
+};
+
+}  // namespace e47
+
+#endif /* SandboxHost_hpp */
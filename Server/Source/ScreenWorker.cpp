@@ -9,6 +9,7 @@
 #include "Message.hpp"
 #include "ImageDiff.hpp"
 #include "App.hpp"
+#include "OverloadGovernor.hpp"
 
 namespace e47 {
 
@@ -66,6 +67,7 @@ void ScreenWorker::runFFmpeg() {
             if (m_imageBuf.size() <= Message<ScreenCapture>::MAX_SIZE) {
                 msg.payload.setImage(m_width, m_height, m_scale, m_imageBuf.data(), m_imageBuf.size());
                 lock.unlock();
+                std::lock_guard<std::mutex> sendLock(m_sendMtx);
                 msg.send(m_socket.get());
             } else {
                 logln(
@@ -145,6 +147,7 @@ void ScreenWorker::runNative() {
                         }
                     } else {
                         msg.payload.setImage(m_width, m_height, 1, mos.getData(), mos.getDataSize());
+                        std::lock_guard<std::mutex> sendLock(m_sendMtx);
                         msg.send(m_socket.get());
                     }
                 }
@@ -152,11 +155,23 @@ void ScreenWorker::runNative() {
         } else {
             // another client took over, notify this one
             msg.payload.setImage(0, 0, 0, nullptr, 0);
+            std::lock_guard<std::mutex> sendLock(m_sendMtx);
             msg.send(m_socket.get());
         }
     }
 }
 
+bool ScreenWorker::sendParameterValues(const MemoryBlock& data) {
+    traceScope();
+    if (nullptr == m_socket || !m_socket->isConnected()) {
+        return false;
+    }
+    Message<ParameterValues> msg(getLogTagSource());
+    msg.payload.setData(static_cast<const char*>(data.getData()), static_cast<int>(data.getSize()));
+    std::lock_guard<std::mutex> lock(m_sendMtx);
+    return msg.send(m_socket.get());
+}
+
 void ScreenWorker::shutdown() {
     traceScope();
     signalThreadShouldExit();
@@ -180,7 +195,7 @@ void ScreenWorker::showEditor(std::shared_ptr<AGProcessor> proc) {
             traceScope();
             getApp()->showEditor(proc, tid, [this](const uint8_t* data, int size, int w, int h, double scale) {
                 traceScope();
-                if (currentThreadShouldExit()) {
+                if (currentThreadShouldExit() || dropFrame()) {
                     return;
                 }
                 std::lock_guard<std::mutex> lock(m_currentImageLock);
@@ -210,7 +225,7 @@ void ScreenWorker::showEditor(std::shared_ptr<AGProcessor> proc) {
             getApp()->showEditor(proc, tid, [this](std::shared_ptr<Image> i, int w, int h) {
                 traceScope();
                 if (nullptr != i) {
-                    if (currentThreadShouldExit()) {
+                    if (currentThreadShouldExit() || dropFrame()) {
                         return;
                     }
                     std::lock_guard<std::mutex> lock(m_currentImageLock);
@@ -249,4 +264,17 @@ void ScreenWorker::hideEditor() {
     m_visible = false;
 }
 
+bool ScreenWorker::dropFrame() {
+    auto governor = OverloadGovernor::getInstance();
+    if (nullptr == governor || !governor->isScreenThrottled()) {
+        return false;
+    }
+    auto now = Time::getMillisecondCounter();
+    if (now - m_lastFrameMs < OverloadGovernor::SCREEN_INTERVAL_MS) {
+        return true;
+    }
+    m_lastFrameMs = now;
+    return false;
+}
+
 }  // namespace e47
@@ -34,8 +34,12 @@ class ScreenWorker : public Thread, public LogTagDelegate {
     void showEditor(std::shared_ptr<AGProcessor> proc);
     void hideEditor();
 
+    // Pushes parameter values to the client, can be called from any thread
+    bool sendParameterValues(const MemoryBlock& data);
+
   private:
     std::unique_ptr<StreamingSocket> m_socket;
+    std::mutex m_sendMtx;
 
     // Native capturing
     std::shared_ptr<Image> m_currentImage, m_lastImage, m_diffImage;
@@ -50,6 +54,10 @@ class ScreenWorker : public Thread, public LogTagDelegate {
     std::condition_variable m_currentImageCv;
 
     std::atomic_bool m_visible{false};
+    uint32 m_lastFrameMs = 0;
+
+    // Returns true, if a frame should be dropped to reduce the frame rate, while the server is overloaded
+    bool dropFrame();
 
     ENABLE_ASYNC_FUNCTORS();
 };
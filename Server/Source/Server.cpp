@@ -12,6 +12,10 @@
 #include "ServiceResponder.hpp"
 #include "CPUInfo.hpp"
 #include "WindowPositions.hpp"
+#include "PluginLoader.hpp"
+#include "PluginPool.hpp"
+#include "DeadlineScheduler.hpp"
+#include "OverloadGovernor.hpp"
 
 #ifdef JUCE_MAC
 #include <sys/socket.h>
@@ -25,12 +29,22 @@ void Server::initialize() {
     traceScope();
     logln("starting server (version: " << AUDIOGRIDDER_VERSION << ", build date: " << AUDIOGRIDDER_BUILD_DATE
                                        << ")...");
-    File runFile(Defaults::getConfigFileName(Defaults::ConfigServerRun));
-    runFile.create();
+    if (!isSandbox()) {
+        File runFile(Defaults::getConfigFileName(Defaults::ConfigServerRun));
+        runFile.create();
+    }
     loadConfig();
     Metrics::initialize();
     CPUInfo::initialize();
     WindowPositions::initialize();
+    PluginLoader::initialize([this](std::shared_ptr<PluginLoader> loader) {
+        // without parallel loading all jobs get serialized by a single worker
+        loader->configure(m_parallelPluginLoad ? m_pluginLoaderWorkers : 1, m_pluginLoaderFormatLimits,
+                          m_pluginLoaderVendorLimits);
+    });
+    PluginPool::initialize();
+    DeadlineScheduler::initialize();
+    OverloadGovernor::initialize();
 }
 
 void Server::loadConfig() {
@@ -113,6 +127,59 @@ void Server::loadConfig() {
     }
     m_scanForPlugins = jsonGetValue(cfg, "ScanForPlugins", m_scanForPlugins);
     m_parallelPluginLoad = jsonGetValue(cfg, "ParallelPluginLoad", m_parallelPluginLoad);
+    // older configs only had a flag for splitting chains into two stages
+    if (jsonGetValue(cfg, "PipelinedProcessing", false)) {
+        m_pipelineStages = 2;
+    }
+    m_pipelineStages = jmax(0, jsonGetValue(cfg, "PipelineStages", m_pipelineStages));
+    if (m_pipelineStages > 1) {
+        logln("pipelined processing with " << m_pipelineStages << " stages");
+    } else {
+        logln("pipelined processing disabled");
+    }
+    m_internalBlockSize = jmax(0, jsonGetValue(cfg, "InternalBlockSize", m_internalBlockSize));
+    logln("internal block size: " << (m_internalBlockSize > 0 ? String(m_internalBlockSize) : "client block size"));
+    m_edfScheduling = jsonGetValue(cfg, "EDFScheduling", m_edfScheduling);
+    logln("earliest deadline first scheduling " << (m_edfScheduling ? "enabled" : "disabled"));
+    m_skipSilence = jsonGetValue(cfg, "SkipSilence", m_skipSilence);
+    logln("skipping silent blocks " << (m_skipSilence ? "enabled" : "disabled"));
+    m_hibernateAfterSec = jmax(0, jsonGetValue(cfg, "HibernateAfterSec", m_hibernateAfterSec));
+    m_hibernateUnload = jsonGetValue(cfg, "HibernateUnload", m_hibernateUnload);
+    if (m_hibernateAfterSec > 0) {
+        logln("hibernating idle chains after " << m_hibernateAfterSec << "s"
+                                               << (m_hibernateUnload ? ", unloading plugins" : ""));
+    }
+    m_pluginLoaderWorkers = jmax(1, jsonGetValue(cfg, "PluginLoaderWorkers", m_pluginLoaderWorkers));
+    auto loadLimits = [&](const String& key, PluginLoader::LimitsMap& limits) {
+        limits.clear();
+        if (jsonHasValue(cfg, key)) {
+            for (auto& kv : cfg[key.toStdString()].items()) {
+                limits[kv.key()] = kv.value().get<int>();
+            }
+        }
+    };
+    loadLimits("PluginLoaderFormatLimits", m_pluginLoaderFormatLimits);
+    loadLimits("PluginLoaderVendorLimits", m_pluginLoaderVendorLimits);
+    m_pluginPoolSize = jsonGetValue(cfg, "PluginPoolSize", m_pluginPoolSize);
+    m_pluginPoolSize = jlimit(0, Defaults::PLUGIN_POOL_MAX_SIZE, m_pluginPoolSize);
+    logln("plugin pool size: " << m_pluginPoolSize);
+    m_overloadMissesPerSec = jmax(0, jsonGetValue(cfg, "OverloadMissesPerSec", m_overloadMissesPerSec));
+    m_overloadReduceScreen = jsonGetValue(cfg, "OverloadReduceScreen", m_overloadReduceScreen);
+    m_overloadRefuseAddPlugin = jsonGetValue(cfg, "OverloadRefuseAddPlugin", m_overloadRefuseAddPlugin);
+    m_overloadAutoBypass = jsonGetValue(cfg, "OverloadAutoBypass", m_overloadAutoBypass);
+    if (m_overloadMissesPerSec > 0) {
+        logln("overload protection at " << m_overloadMissesPerSec << " deadline misses per second"
+                                        << (m_overloadReduceScreen ? ", reducing screen rate" : "")
+                                        << (m_overloadRefuseAddPlugin ? ", refusing new plugins" : "")
+                                        << (m_overloadAutoBypass ? ", bypassing expensive plugins" : ""));
+    }
+    m_memoryBudgetMB = jmax(0, jsonGetValue(cfg, "MemoryBudgetMB", m_memoryBudgetMB));
+    logln("memory budget: " << (m_memoryBudgetMB > 0 ? String(m_memoryBudgetMB) + " MB" : "unlimited"));
+    m_sandboxMode = jsonGetValue(cfg, "SandboxMode", m_sandboxMode);
+    logln("sandbox mode " << (m_sandboxMode ? "enabled" : "disabled"));
+    if (m_sandboxMode) {
+        logln("  buses, sidechains, the memory budget and the overload governor work per client in sandbox mode");
+    }
 }
 
 void Server::saveConfig() {
@@ -157,6 +224,28 @@ void Server::saveConfig() {
     }
     j["ScanForPlugins"] = m_scanForPlugins;
     j["ParallelPluginLoad"] = m_parallelPluginLoad;
+    j["PipelineStages"] = m_pipelineStages;
+    j["InternalBlockSize"] = m_internalBlockSize;
+    j["EDFScheduling"] = m_edfScheduling;
+    j["SkipSilence"] = m_skipSilence;
+    j["HibernateAfterSec"] = m_hibernateAfterSec;
+    j["HibernateUnload"] = m_hibernateUnload;
+    j["PluginLoaderWorkers"] = m_pluginLoaderWorkers;
+    j["PluginLoaderFormatLimits"] = json::object();
+    for (auto& l : m_pluginLoaderFormatLimits) {
+        j["PluginLoaderFormatLimits"][l.first.toStdString()] = l.second;
+    }
+    j["PluginLoaderVendorLimits"] = json::object();
+    for (auto& l : m_pluginLoaderVendorLimits) {
+        j["PluginLoaderVendorLimits"][l.first.toStdString()] = l.second;
+    }
+    j["PluginPoolSize"] = m_pluginPoolSize;
+    j["OverloadMissesPerSec"] = m_overloadMissesPerSec;
+    j["OverloadReduceScreen"] = m_overloadReduceScreen;
+    j["OverloadRefuseAddPlugin"] = m_overloadRefuseAddPlugin;
+    j["OverloadAutoBypass"] = m_overloadAutoBypass;
+    j["MemoryBudgetMB"] = m_memoryBudgetMB;
+    j["SandboxMode"] = m_sandboxMode;
 
     File cfg(Defaults::getConfigFileName(Defaults::ConfigServer));
     if (cfg.exists()) {
@@ -263,14 +352,20 @@ Server::~Server() {
         m_masterSocket.close();
     }
     waitForThreadAndLog(this, this);
+    PluginPool::cleanup();
+    PluginLoader::cleanup();
+    DeadlineScheduler::cleanup();
+    OverloadGovernor::cleanup();
     m_pluginlist.clear();
     Metrics::cleanup();
     ServiceResponder::cleanup();
     CPUInfo::cleanup();
     WindowPositions::cleanup();
     logln("server terminated");
-    File runFile(Defaults::getConfigFileName(Defaults::ConfigServerRun));
-    runFile.deleteFile();
+    if (!isSandbox()) {
+        File runFile(Defaults::getConfigFileName(Defaults::ConfigServerRun));
+        runFile.deleteFile();
+    }
 }
 
 void Server::shutdown() {
@@ -284,6 +379,12 @@ void Server::shutdown() {
     for (auto& w : m_workers) {
         w->waitForThreadToExit(-1);
     }
+    for (auto& s : m_sandboxes) {
+        s->shutdown();
+    }
+    for (auto& s : m_sandboxes) {
+        s->waitForThreadToExit(-1);
+    }
     signalThreadShouldExit();
 }
 
@@ -503,6 +604,10 @@ void Server::scanForPlugins(const std::vector<String>& include) {
 
 void Server::run() {
     traceScope();
+    if (isSandbox()) {
+        runSandbox();
+        return;
+    }
     if ((m_scanForPlugins || getOpt("ScanForPlugins", false)) && !getOpt("NoScanForPlugins", false)) {
         scanForPlugins();
     } else {
@@ -567,9 +672,15 @@ void Server::run() {
             auto* clnt = m_masterSocket.waitForNextConnection();
             if (nullptr != clnt) {
                 logln("new client " << clnt->getHostName());
-                auto w = std::make_shared<Worker>(clnt);
-                w->startThread();
-                m_workers.add(w);
+                if (m_sandboxMode) {
+                    auto s = std::make_shared<SandboxHost>(clnt);
+                    s->startThread();
+                    m_sandboxes.add(s);
+                } else {
+                    auto w = std::make_shared<Worker>(clnt);
+                    w->startThread();
+                    m_workers.add(w);
+                }
                 // lazy cleanup
                 std::shared_ptr<WorkerList> deadWorkers = std::make_shared<WorkerList>();
                 for (int i = 0; i < m_workers.size();) {
@@ -582,6 +693,17 @@ void Server::run() {
                 }
                 traceln("about to remove " << deadWorkers->size() << " dead workers");
                 deadWorkers->clear();
+                std::shared_ptr<SandboxList> deadSandboxes = std::make_shared<SandboxList>();
+                for (int i = 0; i < m_sandboxes.size();) {
+                    if (!m_sandboxes.getReference(i)->isThreadRunning()) {
+                        deadSandboxes->add(m_sandboxes.getReference(i));
+                        m_sandboxes.remove(i);
+                    } else {
+                        i++;
+                    }
+                }
+                traceln("about to remove " << deadSandboxes->size() << " dead sandboxes");
+                deadSandboxes->clear();
             }
         }
     } else {
@@ -603,4 +725,26 @@ void Server::run() {
     }
 }
 
+void Server::runSandbox() {
+    traceScope();
+    loadKnownPluginList();
+    int port = getOpt("SandboxPort", 0);
+    auto clientHost = getOpt("SandboxClientHost", String());
+    logln("sandbox for client " << clientHost << " started, connecting to server port " << port);
+    auto sock = std::make_unique<StreamingSocket>();
+    if (sock->connect("127.0.0.1", port)) {
+        auto w = std::make_shared<Worker>(sock.release(), clientHost);
+        w->startThread();
+        m_workers.add(w);
+        while (!currentThreadShouldExit() && w->isThreadRunning()) {
+            sleep(100);
+        }
+    } else {
+        logln("error: failed to connect to the server");
+    }
+    logln("sandbox terminated");
+    // the sandbox process lives as long as its client is connected
+    runOnMsgThreadAsync([] { getApp()->prepareShutdown(); });
+}
+
 }  // namespace e47
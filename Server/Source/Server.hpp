@@ -15,9 +15,11 @@
 #include "Worker.hpp"
 #include "Defaults.hpp"
 #include "ProcessorChain.hpp"
+#include "PluginLoader.hpp"
 #include "Utils.hpp"
 #include "json.hpp"
 #include "ScreenRecorder.hpp"
+#include "SandboxHost.hpp"
 
 namespace e47 {
 
@@ -63,6 +65,36 @@ class Server : public Thread, public LogTag {
     void setScanForPlugins(bool b) { m_scanForPlugins = b; }
     bool getParallelPluginLoad() const { return m_parallelPluginLoad; }
     void setParallelPluginLoad(bool b) { m_parallelPluginLoad = b; }
+    int getPipelineStages() const { return m_pipelineStages; }
+    void setPipelineStages(int n) { m_pipelineStages = n; }
+    int getInternalBlockSize() const { return m_internalBlockSize; }
+    void setInternalBlockSize(int n) { m_internalBlockSize = n; }
+    bool getEDFScheduling() const { return m_edfScheduling; }
+    void setEDFScheduling(bool b) { m_edfScheduling = b; }
+    bool getSkipSilence() const { return m_skipSilence; }
+    void setSkipSilence(bool b) { m_skipSilence = b; }
+    int getHibernateAfterSec() const { return m_hibernateAfterSec; }
+    void setHibernateAfterSec(int n) { m_hibernateAfterSec = n; }
+    bool getHibernateUnload() const { return m_hibernateUnload; }
+    void setHibernateUnload(bool b) { m_hibernateUnload = b; }
+    int getPluginLoaderWorkers() const { return m_pluginLoaderWorkers; }
+    void setPluginLoaderWorkers(int n) { m_pluginLoaderWorkers = n; }
+    int getPluginPoolSize() const { return m_pluginPoolSize; }
+    void setPluginPoolSize(int n) { m_pluginPoolSize = n; }
+    int getOverloadMissesPerSec() const { return m_overloadMissesPerSec; }
+    void setOverloadMissesPerSec(int n) { m_overloadMissesPerSec = n; }
+    bool getOverloadReduceScreen() const { return m_overloadReduceScreen; }
+    void setOverloadReduceScreen(bool b) { m_overloadReduceScreen = b; }
+    bool getOverloadRefuseAddPlugin() const { return m_overloadRefuseAddPlugin; }
+    void setOverloadRefuseAddPlugin(bool b) { m_overloadRefuseAddPlugin = b; }
+    bool getOverloadAutoBypass() const { return m_overloadAutoBypass; }
+    void setOverloadAutoBypass(bool b) { m_overloadAutoBypass = b; }
+    int getMemoryBudgetMB() const { return m_memoryBudgetMB; }
+    void setMemoryBudgetMB(int n) { m_memoryBudgetMB = n; }
+    bool getSandboxMode() const { return m_sandboxMode; }
+    void setSandboxMode(bool b) { m_sandboxMode = b; }
+    // True if this server process hosts a single client in a sandbox
+    bool isSandbox() const { return getOpt("SandboxPort", 0) > 0; }
     void run();
     const KnownPluginList& getPluginList() const { return m_pluginlist; }
     KnownPluginList& getPluginList() { return m_pluginlist; }
@@ -84,6 +116,8 @@ class Server : public Thread, public LogTag {
     StreamingSocket m_masterSocket;
     using WorkerList = Array<std::shared_ptr<Worker>>;
     WorkerList m_workers;
+    using SandboxList = Array<std::shared_ptr<SandboxHost>>;
+    SandboxList m_sandboxes;
     KnownPluginList m_pluginlist;
     std::set<String> m_pluginexclude;
     bool m_enableAU = true;
@@ -100,6 +134,23 @@ class Server : public Thread, public LogTag {
     bool m_vstNoStandardFolders;
     bool m_scanForPlugins = true;
     bool m_parallelPluginLoad = false;
+    int m_pipelineStages = 0;
+    int m_internalBlockSize = 0;
+    bool m_edfScheduling = false;
+    bool m_skipSilence = true;
+    int m_hibernateAfterSec = 0;
+    bool m_hibernateUnload = false;
+    int m_pluginLoaderWorkers = Defaults::DEFAULT_PLUGIN_LOADER_WORKERS;
+    PluginLoader::LimitsMap m_pluginLoaderFormatLimits, m_pluginLoaderVendorLimits;
+    int m_pluginPoolSize = 0;
+    int m_overloadMissesPerSec = 0;
+    bool m_overloadReduceScreen = true;
+    bool m_overloadRefuseAddPlugin = true;
+    bool m_overloadAutoBypass = false;
+    int m_memoryBudgetMB = 0;
+    bool m_sandboxMode = false;
+
+    void runSandbox();
 
     void scanNextPlugin(const String& id, const String& fmt);
     void scanForPlugins();
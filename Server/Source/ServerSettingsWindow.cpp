@@ -384,6 +384,191 @@ ServerSettingsWindow::ServerSettingsWindow(App* app)
 
     row++;
 
+    label = std::make_unique<Label>();
+    label->setText("Parallel Plugin Loader Threads:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String loaderWorkers;
+    loaderWorkers << m_app->getServer().getPluginLoaderWorkers();
+    m_pluginLoaderWorkers.setText(loaderWorkers);
+    m_pluginLoaderWorkers.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_pluginLoaderWorkers, "loaders");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Pipelined chain stages (+1 block per stage):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String pipelineStages;
+    pipelineStages << m_app->getServer().getPipelineStages();
+    m_pipelineStages.setText(pipelineStages);
+    m_pipelineStages.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_pipelineStages, "pipeline");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Internal block size (0 = client's):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String blockSize;
+    blockSize << m_app->getServer().getInternalBlockSize();
+    m_internalBlockSize.setText(blockSize);
+    m_internalBlockSize.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_internalBlockSize, "blocksize");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Earliest deadline first scheduling:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_edfScheduling.setBounds(getCheckBoxBounds(row));
+    m_edfScheduling.setToggleState(m_app->getServer().getEDFScheduling(), NotificationType::dontSendNotification);
+    addChildAndSetID(&m_edfScheduling, "edf");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Skip processing of silent blocks:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_skipSilence.setBounds(getCheckBoxBounds(row));
+    m_skipSilence.setToggleState(m_app->getServer().getSkipSilence(), NotificationType::dontSendNotification);
+    addChildAndSetID(&m_skipSilence, "silence");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Hibernate idle chains after (sec, 0 = off):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String hibernateAfter;
+    hibernateAfter << m_app->getServer().getHibernateAfterSec();
+    m_hibernateAfterSec.setText(hibernateAfter);
+    m_hibernateAfterSec.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_hibernateAfterSec, "hibernate");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Unload plugins when hibernating:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_hibernateUnload.setBounds(getCheckBoxBounds(row));
+    m_hibernateUnload.setToggleState(m_app->getServer().getHibernateUnload(), NotificationType::dontSendNotification);
+    addChildAndSetID(&m_hibernateUnload, "hibernateunload");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Warm instances per plugin (0 = off):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String poolSize;
+    poolSize << m_app->getServer().getPluginPoolSize();
+    m_pluginPoolSize.setText(poolSize);
+    m_pluginPoolSize.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_pluginPoolSize, "pool");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Memory budget (MB, 0 = unlimited):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String memoryBudget;
+    memoryBudget << m_app->getServer().getMemoryBudgetMB();
+    m_memoryBudgetMB.setText(memoryBudget);
+    m_memoryBudgetMB.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_memoryBudgetMB, "membudget");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Overload protection (misses/sec, 0 = off):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    String overloadMisses;
+    overloadMisses << m_app->getServer().getOverloadMissesPerSec();
+    m_overloadMissesPerSec.setText(overloadMisses);
+    m_overloadMissesPerSec.setBounds(getFieldBounds(row));
+    addChildAndSetID(&m_overloadMissesPerSec, "overload");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Overload: Reduce screen frame rate:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_overloadReduceScreen.setBounds(getCheckBoxBounds(row));
+    m_overloadReduceScreen.setToggleState(m_app->getServer().getOverloadReduceScreen(),
+                                          NotificationType::dontSendNotification);
+    addChildAndSetID(&m_overloadReduceScreen, "overloadscreen");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Overload: Refuse to add plugins:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_overloadRefuseAddPlugin.setBounds(getCheckBoxBounds(row));
+    m_overloadRefuseAddPlugin.setToggleState(m_app->getServer().getOverloadRefuseAddPlugin(),
+                                             NotificationType::dontSendNotification);
+    addChildAndSetID(&m_overloadRefuseAddPlugin, "overloadadd");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Overload: Bypass expensive effects:", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_overloadAutoBypass.setBounds(getCheckBoxBounds(row));
+    m_overloadAutoBypass.setToggleState(m_app->getServer().getOverloadAutoBypass(),
+                                        NotificationType::dontSendNotification);
+    addChildAndSetID(&m_overloadAutoBypass, "overloadbypass");
+
+    row++;
+
+    label = std::make_unique<Label>();
+    label->setText("Sandbox (one process per client):", NotificationType::dontSendNotification);
+    label->setBounds(getLabelBounds(row));
+    addChildAndSetID(label.get(), "lbl");
+    m_components.push_back(std::move(label));
+
+    m_sandboxMode.setBounds(getCheckBoxBounds(row));
+    m_sandboxMode.setToggleState(m_app->getServer().getSandboxMode(), NotificationType::dontSendNotification);
+    addChildAndSetID(&m_sandboxMode, "sandbox");
+
+    row++;
+
     label = std::make_unique<Label>();
     label->setText("Diagnostics", NotificationType::dontSendNotification);
     label->setJustificationType(Justification::centredTop);
@@ -437,6 +622,21 @@ ServerSettingsWindow::ServerSettingsWindow(App* app)
         appCpy->getServer().setEnableVST2(m_vst2Support.getToggleState());
         appCpy->getServer().setScanForPlugins(m_scanForPlugins.getToggleState());
         appCpy->getServer().setParallelPluginLoad(m_parallelPluginLoad.getToggleState());
+        appCpy->getServer().setPluginLoaderWorkers(jmax(1, m_pluginLoaderWorkers.getText().getIntValue()));
+        appCpy->getServer().setPipelineStages(jmax(0, m_pipelineStages.getText().getIntValue()));
+        appCpy->getServer().setEDFScheduling(m_edfScheduling.getToggleState());
+        appCpy->getServer().setSkipSilence(m_skipSilence.getToggleState());
+        appCpy->getServer().setHibernateAfterSec(jmax(0, m_hibernateAfterSec.getText().getIntValue()));
+        appCpy->getServer().setHibernateUnload(m_hibernateUnload.getToggleState());
+        appCpy->getServer().setInternalBlockSize(jmax(0, m_internalBlockSize.getText().getIntValue()));
+        appCpy->getServer().setPluginPoolSize(
+            jlimit(0, Defaults::PLUGIN_POOL_MAX_SIZE, m_pluginPoolSize.getText().getIntValue()));
+        appCpy->getServer().setMemoryBudgetMB(jmax(0, m_memoryBudgetMB.getText().getIntValue()));
+        appCpy->getServer().setOverloadMissesPerSec(jmax(0, m_overloadMissesPerSec.getText().getIntValue()));
+        appCpy->getServer().setOverloadReduceScreen(m_overloadReduceScreen.getToggleState());
+        appCpy->getServer().setOverloadRefuseAddPlugin(m_overloadRefuseAddPlugin.getToggleState());
+        appCpy->getServer().setOverloadAutoBypass(m_overloadAutoBypass.getToggleState());
+        appCpy->getServer().setSandboxMode(m_sandboxMode.getToggleState());
         switch (m_screenCapturingMode.getSelectedId()) {
             case 1:
                 appCpy->getServer().setScreenCapturingFFmpeg(true);
@@ -26,9 +26,12 @@ class ServerSettingsWindow : public DocumentWindow, public LogTag {
   private:
     App* m_app;
     std::vector<std::unique_ptr<Component>> m_components;
-    TextEditor m_idText, m_nameText, m_screenJpgQuality, m_vst2Folders, m_vst3Folders;
+    TextEditor m_idText, m_nameText, m_screenJpgQuality, m_vst2Folders, m_vst3Folders, m_pluginLoaderWorkers,
+        m_pluginPoolSize, m_internalBlockSize, m_hibernateAfterSec, m_overloadMissesPerSec,
+        m_memoryBudgetMB, m_pipelineStages;
     ToggleButton m_auSupport, m_vst3Support, m_vst2Support, m_screenDiffDetection, m_scanForPlugins, m_tracer, m_logger,
-        m_vstNoStandardFolders, m_parallelPluginLoad;
+        m_vstNoStandardFolders, m_parallelPluginLoad, m_edfScheduling, m_skipSilence,
+        m_hibernateUnload, m_overloadReduceScreen, m_overloadRefuseAddPlugin, m_overloadAutoBypass, m_sandboxMode;
     TextButton m_saveButton;
     Label m_screenJpgQualityLbl, m_screenDiffDetectionLbl, m_screenCapturingQualityLbl;
     ComboBox m_screenCapturingMode, m_screenCapturingQuality;
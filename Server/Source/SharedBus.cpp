@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SharedBus.hpp"
+
+namespace e47 {
+
+std::unordered_map<String, std::weak_ptr<SharedBus>> SharedBus::m_buses;
+std::mutex SharedBus::m_busesMtx;
+
+SharedBus::SharedBus(const String& name) : LogTag("bus"), m_name(name) {
+    traceScope();
+    m_lateSends = Metrics::getStatistic<Meter>("BusLateSend");
+    m_overruns = Metrics::getStatistic<Meter>("BusOverrun");
+    logln("bus " << m_name << " created");
+}
+
+SharedBus::~SharedBus() {
+    traceScope();
+    logln("bus " << m_name << " deleted");
+}
+
+std::shared_ptr<SharedBus> SharedBus::getBus(const String& name) {
+    setLogTagStatic("bus");
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_busesMtx);
+    auto bus = m_buses[name].lock();
+    if (nullptr == bus) {
+        bus = std::make_shared<SharedBus>(name);
+        m_buses[name] = bus;
+    }
+    // drop the entries of deleted buses
+    for (auto it = m_buses.begin(); it != m_buses.end();) {
+        if (it->second.expired()) {
+            it = m_buses.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return bus;
+}
+
+void SharedBus::addSend(const void* id, int channels, int samples) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto& slot = m_slots[id];
+    for (auto& block : slot.blocks) {
+        block.setSize(channels, samples);
+    }
+    logln("bus " << m_name << ": " << m_slots.size() << " send(s)");
+}
+
+void SharedBus::removeSend(const void* id) {
+    traceScope();
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_slots.erase(id);
+        logln("bus " << m_name << ": " << m_slots.size() << " send(s)");
+    }
+    // the return might wait for the removed send
+    m_cv.notify_one();
+}
+
+bool SharedBus::addReturn(const void* id) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (nullptr != m_return && m_return != id) {
+        return false;
+    }
+    m_return = id;
+    return true;
+}
+
+void SharedBus::removeReturn(const void* id) {
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_mtx);
+    if (m_return == id) {
+        m_return = nullptr;
+    }
+}
+
+}  // namespace e47
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SharedBus_hpp
+#define SharedBus_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <unordered_map>
+
+#include "Utils.hpp"
+#include "Metrics.hpp"
+
+namespace e47 {
+
+/*
+ * A named bus shared by multiple audio workers. Send workers deliver their output for every block, the return worker
+ * mixes the delivered blocks into its input before processing its chain. So a chain on the return worker, like a
+ * reverb, is processed once for all sends. All workers on a bus should use the same sample rate and block size.
+ *
+ * Every send queues up to QUEUE_SIZE blocks, so a send can run one block ahead of the return. If a send gets further
+ * ahead, its oldest block is dropped and counted as overrun. A bus has only one return.
+ */
+class SharedBus : public LogTag {
+  public:
+    SharedBus(const String& name);
+    ~SharedBus() override;
+
+    static std::shared_ptr<SharedBus> getBus(const String& name);
+
+    const String& getName() const { return m_name; }
+
+    // The queue of a send is allocated for the given number of channels and samples, so that sending does not
+    // allocate on the audio thread
+    void addSend(const void* id, int channels, int samples);
+    void removeSend(const void* id);
+
+    // Returns false, if another worker is the return of the bus already
+    bool addReturn(const void* id);
+    void removeReturn(const void* id);
+
+    static constexpr int QUEUE_SIZE = 2;
+
+    // Queues the output of a send for the next block of the return
+    template <typename T>
+    void send(const void* id, const AudioBuffer<T>& buffer, int channels) {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto it = m_slots.find(id);
+        if (it == m_slots.end()) {
+            return;
+        }
+        auto& slot = it->second;
+        if (slot.count == QUEUE_SIZE) {
+            // the return did not pick up the queued blocks in time, drop the oldest
+            slot.readPos = (slot.readPos + 1) % QUEUE_SIZE;
+            slot.count--;
+            m_overruns->increment();
+        }
+        auto& block = slot.blocks[(slot.readPos + slot.count) % QUEUE_SIZE];
+        channels = jmin(channels, buffer.getNumChannels());
+        int samples = buffer.getNumSamples();
+        // does not allocate as long as the block fits into the preallocated size
+        block.setSize(channels, samples, false, false, true);
+        for (int c = 0; c < channels; c++) {
+            auto* src = buffer.getReadPointer(c);
+            auto* dst = block.getWritePointer(c);
+            for (int s = 0; s < samples; s++) {
+                dst[s] = (double)src[s];
+            }
+        }
+        slot.count++;
+        if (allFreshNoLock()) {
+            m_cv.notify_one();
+        }
+    }
+
+    // Waits up to timeoutMs for all sends to deliver their block and adds the delivered blocks to the given buffer.
+    // Returns true, if any delivered block was not silent.
+    template <typename T>
+    bool receive(AudioBuffer<T>& buffer, int timeoutMs) {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        if (!m_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return allFreshNoLock(); })) {
+            m_lateSends->increment();
+        }
+        bool signal = false;
+        for (auto& kv : m_slots) {
+            auto& slot = kv.second;
+            if (slot.count == 0) {
+                continue;
+            }
+            auto& block = slot.blocks[slot.readPos];
+            int channels = jmin(buffer.getNumChannels(), block.getNumChannels());
+            int samples = jmin(buffer.getNumSamples(), block.getNumSamples());
+            for (int c = 0; c < channels; c++) {
+                auto* src = block.getReadPointer(c);
+                auto* dst = buffer.getWritePointer(c);
+                for (int s = 0; s < samples; s++) {
+                    dst[s] += (T)src[s];
+                }
+                signal = signal || block.getMagnitude(c, 0, samples) > 0;
+            }
+            slot.readPos = (slot.readPos + 1) % QUEUE_SIZE;
+            slot.count--;
+        }
+        return signal;
+    }
+
+  private:
+    struct Slot {
+        AudioBuffer<double> blocks[QUEUE_SIZE];
+        int readPos = 0;
+        int count = 0;
+    };
+
+    String m_name;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::unordered_map<const void*, Slot> m_slots;
+    const void* m_return = nullptr;
+    std::shared_ptr<Meter> m_lateSends;
+    std::shared_ptr<Meter> m_overruns;
+
+    static std::unordered_map<String, std::weak_ptr<SharedBus>> m_buses;
+    static std::mutex m_busesMtx;
+
+    bool allFreshNoLock() const {
+        for (auto& kv : m_slots) {
+            if (kv.second.count == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}  // namespace e47
+
+#endif /* SharedBus_hpp */
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "SidechainSource.hpp"
+
+namespace e47 {
+
+std::unordered_map<String, std::weak_ptr<SidechainSource>> SidechainSource::m_sources;
+std::mutex SidechainSource::m_sourcesMtx;
+
+SidechainSource::SidechainSource(const String& name) : LogTag("sidechain"), m_name(name) {
+    traceScope();
+    m_misses = Metrics::getStatistic<Meter>("SidechainMiss");
+    logln("sidechain source " << m_name << " created");
+}
+
+SidechainSource::~SidechainSource() {
+    traceScope();
+    logln("sidechain source " << m_name << " deleted");
+}
+
+std::shared_ptr<SidechainSource> SidechainSource::getSource(const String& name) {
+    setLogTagStatic("sidechain");
+    traceScope();
+    std::lock_guard<std::mutex> lock(m_sourcesMtx);
+    auto source = m_sources[name].lock();
+    if (nullptr == source) {
+        source = std::make_shared<SidechainSource>(name);
+        m_sources[name] = source;
+    }
+    // drop the entries of deleted sources
+    for (auto it = m_sources.begin(); it != m_sources.end();) {
+        if (it->second.expired()) {
+            it = m_sources.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return source;
+}
+
+}  // namespace e47
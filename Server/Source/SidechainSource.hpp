@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef SidechainSource_hpp
+#define SidechainSource_hpp
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <unordered_map>
+
+#include "Utils.hpp"
+#include "Metrics.hpp"
+
+namespace e47 {
+
+/*
+ * A named audio stream published by an audio worker, that other audio workers can read into the sidechain channels
+ * of their chains. The last blocks are kept with their timeline position, so that a reader gets the audio matching
+ * its own timeline range while the transport is running, even if the block sizes differ. Otherwise the latest block
+ * is used.
+ */
+class SidechainSource : public LogTag {
+  public:
+    SidechainSource(const String& name);
+    ~SidechainSource() override;
+
+    static std::shared_ptr<SidechainSource> getSource(const String& name);
+
+    const String& getName() const { return m_name; }
+
+    void addPublisher() { m_publishers++; }
+    void removePublisher() {
+        m_publishers--;
+        m_cv.notify_all();
+    }
+
+    template <typename T>
+    void publish(const AudioBuffer<T>& buffer, int channels, int64 position) {
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            auto& block = m_blocks[m_next];
+            m_next = (m_next + 1) % NUM_OF_BLOCKS;
+            channels = jmin(channels, buffer.getNumChannels());
+            int samples = buffer.getNumSamples();
+            block.buffer.setSize(channels, samples, false, false, true);
+            for (int c = 0; c < channels; c++) {
+                auto* src = buffer.getReadPointer(c);
+                auto* dst = block.buffer.getWritePointer(c);
+                for (int s = 0; s < samples; s++) {
+                    dst[s] = (double)src[s];
+                }
+            }
+            block.position = position;
+            block.seq = ++m_seq;
+        }
+        m_cv.notify_all();
+    }
+
+    // Copies the published audio of the timeline range starting at the given position (or the latest block, if
+    // position is negative) into the channels of the given buffer starting at firstChannel. Waits up to timeoutMs for
+    // the audio. A reader passes the sequence number of the last block it got, so that a block is never delivered
+    // twice for different ranges. The channels stay silent, if nothing new has been published. Returns true, if the
+    // copied audio was not silent.
+    template <typename T>
+    bool read(AudioBuffer<T>& buffer, int firstChannel, int64 position, int timeoutMs, uint64& lastSeq) {
+        int samples = buffer.getNumSamples();
+        for (int c = firstChannel; c < buffer.getNumChannels(); c++) {
+            buffer.clear(c, 0, samples);
+        }
+        std::unique_lock<std::mutex> lock(m_mtx);
+        auto isNew = [&](const Block& b) { return b.seq > lastSeq; };
+        auto hasNew = [&] {
+            for (auto& b : m_blocks) {
+                if (isNew(b)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        // the range is complete, when the block with its last sample has been published
+        auto hasRangeEnd = [&] {
+            for (auto& b : m_blocks) {
+                if (b.seq > 0 && overlaps(b, position + samples - 1, 1)) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        // don't wait for a source that is not published
+        if (!m_cv.wait_for(lock, std::chrono::milliseconds(m_publishers > 0 ? timeoutMs : 0),
+                           [&] { return position < 0 ? hasNew() : hasRangeEnd(); })) {
+            if (m_publishers > 0) {
+                m_misses->increment();
+            }
+        }
+        bool signal = false;
+        bool copied = false;
+        if (position >= 0) {
+            for (auto& b : m_blocks) {
+                if (b.seq > 0 && overlaps(b, position, samples)) {
+                    auto from = jmax(position, b.position);
+                    auto to = jmin(position + samples, b.position + b.buffer.getNumSamples());
+                    signal = copy(b, buffer, firstChannel, (int)(from - position), (int)(from - b.position),
+                                  (int)(to - from)) ||
+                             signal;
+                    lastSeq = jmax(lastSeq, b.seq);
+                    copied = true;
+                }
+            }
+        }
+        if (!copied) {
+            // the latest block, that has not been read yet, if the source has no matching range
+            const Block* latest = nullptr;
+            for (auto& b : m_blocks) {
+                if (isNew(b) && (nullptr == latest || b.seq > latest->seq)) {
+                    latest = &b;
+                }
+            }
+            if (nullptr != latest) {
+                signal = copy(*latest, buffer, firstChannel, 0, 0, jmin(samples, latest->buffer.getNumSamples()));
+                lastSeq = latest->seq;
+            }
+        }
+        return signal;
+    }
+
+  private:
+    static constexpr int NUM_OF_BLOCKS = 4;
+
+    struct Block {
+        AudioBuffer<double> buffer;
+        int64 position = 0;
+        uint64 seq = 0;
+    };
+
+    String m_name;
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    Block m_blocks[NUM_OF_BLOCKS];
+    int m_next = 0;
+    uint64 m_seq = 0;
+    std::atomic_int m_publishers{0};
+    std::shared_ptr<Meter> m_misses;
+
+    static std::unordered_map<String, std::weak_ptr<SidechainSource>> m_sources;
+    static std::mutex m_sourcesMtx;
+
+    static bool overlaps(const Block& b, int64 position, int samples) {
+        return b.position >= 0 && b.position < position + samples && position < b.position + b.buffer.getNumSamples();
+    }
+
+    template <typename T>
+    static bool copy(const Block& b, AudioBuffer<T>& buffer, int firstChannel, int dstStart, int srcStart, int num) {
+        bool signal = false;
+        int channels = jmin(buffer.getNumChannels() - firstChannel, b.buffer.getNumChannels());
+        for (int c = 0; c < channels; c++) {
+            auto* src = b.buffer.getReadPointer(c, srcStart);
+            auto* dst = buffer.getWritePointer(firstChannel + c, dstStart);
+            for (int s = 0; s < num; s++) {
+                dst[s] = (T)src[s];
+            }
+            signal = signal || b.buffer.getMagnitude(c, srcStart, num) > 0;
+        }
+        return signal;
+    }
+};
+
+}  // namespace e47
+
+#endif /* SidechainSource_hpp */
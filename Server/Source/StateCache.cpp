@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include "StateCache.hpp"
+
+namespace e47 {
+
+std::unordered_map<String, StateCache::Entry> StateCache::m_entries;
+size_t StateCache::m_size = 0;
+uint64 StateCache::m_tick = 0;
+std::mutex StateCache::m_mtx;
+
+void StateCache::add(const String& hash, const MemoryBlock& block) {
+    if (hash.isEmpty() || block.getSize() > MAX_SIZE) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) {
+        it->second.lastUsed = ++m_tick;
+        return;
+    }
+    m_entries[hash] = {block, ++m_tick};
+    m_size += block.getSize();
+    while (m_size > MAX_SIZE) {
+        auto oldest = m_entries.begin();
+        for (auto e = m_entries.begin(); e != m_entries.end(); ++e) {
+            if (e->second.lastUsed < oldest->second.lastUsed) {
+                oldest = e;
+            }
+        }
+        m_size -= oldest->second.block.getSize();
+        m_entries.erase(oldest);
+    }
+}
+
+bool StateCache::get(const String& hash, MemoryBlock& block) {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    it->second.lastUsed = ++m_tick;
+    block = it->second.block;
+    return true;
+}
+
+}  // namespace e47
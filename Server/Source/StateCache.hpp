@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#ifndef StateCache_hpp
+#define StateCache_hpp
+
+#include <JuceHeader.h>
+#include <unordered_map>
+
+namespace e47 {
+
+/*
+ * Content addressed store for plugin states. Every state, that the server sends to or receives from a client, is
+ * kept by its hash, so that a client can load a known state by sending the hash only. The least recently used
+ * states are dropped, when the cache exceeds its size limit.
+ */
+class StateCache {
+  public:
+    static void add(const String& hash, const MemoryBlock& block);
+    static bool get(const String& hash, MemoryBlock& block);
+
+  private:
+    static constexpr size_t MAX_SIZE = 256 * 1024 * 1024;
+
+    struct Entry {
+        MemoryBlock block;
+        uint64 lastUsed;
+    };
+
+    static std::unordered_map<String, Entry> m_entries;
+    static size_t m_size;
+    static uint64 m_tick;
+    static std::mutex m_mtx;
+};
+
+}  // namespace e47
+
+#endif /* StateCache_hpp */
@@ -9,6 +9,7 @@
 #include "App.hpp"
 #include "CPUInfo.hpp"
 #include "Metrics.hpp"
+#include "MemoryInfo.hpp"
 #include "WindowPositions.hpp"
 
 namespace e47 {
@@ -30,6 +31,7 @@ StatisticsWindow::StatisticsWindow(App* app)
     int rowHeight = 25;
 
     int fieldWidth = 80;
+    int wideFieldWidth = 200;
     int fieldHeight = 25;
     int labelWidth = 250;
     int labelHeight = 30;
@@ -41,6 +43,10 @@ StatisticsWindow::StatisticsWindow(App* app)
         return juce::Rectangle<int>(totalWidth - fieldWidth - borderLR, borderTB + r * rowHeight + 3, fieldWidth,
                                     fieldHeight);
     };
+    auto getWideFieldBounds = [&](int r) {
+        return juce::Rectangle<int>(totalWidth - wideFieldWidth - borderLR, borderTB + r * rowHeight + 3,
+                                    wideFieldWidth, fieldHeight);
+    };
     auto getLineBounds = [&](int r) {
         return juce::Rectangle<int>(5, borderTB + r * rowHeight, totalWidth - borderLR, rowHeight);
     };
@@ -155,6 +161,13 @@ StatisticsWindow::StatisticsWindow(App* app)
 
     row++;
 
+    addLabel("Deadline misses (per minute):", getLabelBounds(row, 15));
+    m_audioDeadlineMisses.setBounds(getFieldBounds(row));
+    m_audioDeadlineMisses.setJustificationType(Justification::right);
+    addChildAndSetID(&m_audioDeadlineMisses, "audiodlmiss");
+
+    row++;
+
     line = std::make_unique<HirozontalLine>(getLineBounds(row++));
     addChildAndSetID(line.get(), "line");
     m_components.push_back(std::move(line));
@@ -174,13 +187,65 @@ StatisticsWindow::StatisticsWindow(App* app)
 
     row++;
 
+    line = std::make_unique<HirozontalLine>(getLineBounds(row++));
+    addChildAndSetID(line.get(), "line");
+    m_components.push_back(std::move(line));
+
+    addLabel("Plugin processing time (top " + String(NUM_OF_PLUGIN_ROWS) + ")", getLabelBounds(row++));
+    for (int i = 0; i < NUM_OF_PLUGIN_ROWS; i++) {
+        m_pluginNames[i].setBounds(getLabelBounds(row, 15).withWidth(totalWidth - wideFieldWidth - borderLR * 2));
+        addChildAndSetID(&m_pluginNames[i], "pluginname");
+        m_pluginTimes[i].setBounds(getWideFieldBounds(row));
+        m_pluginTimes[i].setJustificationType(Justification::right);
+        addChildAndSetID(&m_pluginTimes[i], "plugintime");
+        row++;
+    }
+
+    line = std::make_unique<HirozontalLine>(getLineBounds(row++));
+    addChildAndSetID(line.get(), "line");
+    m_components.push_back(std::move(line));
+
+    addLabel("Memory", getLabelBounds(row++));
+    addLabel("Resident:", getLabelBounds(row, 15));
+    m_memResident.setBounds(getFieldBounds(row));
+    m_memResident.setJustificationType(Justification::right);
+    addChildAndSetID(&m_memResident, "memresident");
+
+    row++;
+
+    addLabel("Plugins:", getLabelBounds(row, 15));
+    m_memPlugins.setBounds(getFieldBounds(row));
+    m_memPlugins.setJustificationType(Justification::right);
+    addChildAndSetID(&m_memPlugins, "memplugins");
+
+    row++;
+
+    addLabel("Budget:", getLabelBounds(row, 15));
+    m_memBudget.setBounds(getFieldBounds(row));
+    m_memBudget.setJustificationType(Justification::right);
+    addChildAndSetID(&m_memBudget, "membudget");
+
+    row++;
+
+    addLabel("Memory by plugin/client (top " + String(NUM_OF_PLUGIN_ROWS) + ")", getLabelBounds(row++));
+    for (int i = 0; i < NUM_OF_PLUGIN_ROWS; i++) {
+        m_memNames[i].setBounds(getLabelBounds(row, 15).withWidth(totalWidth - fieldWidth - borderLR * 2));
+        addChildAndSetID(&m_memNames[i], "memname");
+        m_memSizes[i].setBounds(getFieldBounds(row));
+        m_memSizes[i].setJustificationType(Justification::right);
+        addChildAndSetID(&m_memSizes[i], "memsize");
+        row++;
+    }
+
     totalHeight += row * rowHeight;
 
     auto audioTime = Metrics::getStatistic<TimeStatistic>("audio");
     auto bytesOutMeter = Metrics::getStatistic<Meter>("NetBytesOut");
     auto bytesInMeter = Metrics::getStatistic<Meter>("NetBytesIn");
+    auto deadlineMissMeter = Metrics::getStatistic<Meter>("DeadlineMiss");
+    auto pluginMemGauge = Metrics::getStatistic<Gauge>("PluginMemory");
 
-    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter] {
+    m_updater.set([this, audioTime, bytesOutMeter, bytesInMeter, deadlineMissMeter, pluginMemGauge] {
         traceScope();
         m_cpu.setText(String(CPUInfo::getUsage(), 2) + "%", NotificationType::dontSendNotification);
         m_totalWorkers.setText(String(Worker::count), NotificationType::dontSendNotification);
@@ -199,6 +264,8 @@ StatisticsWindow::StatisticsWindow(App* app)
         m_audioPTavg.setText(String(hist.avg, 2) + " ms", NotificationType::dontSendNotification);
         m_audioPTmin.setText(String(hist.min, 2) + " ms", NotificationType::dontSendNotification);
         m_audioPTmax.setText(String(hist.max, 2) + " ms", NotificationType::dontSendNotification);
+        m_audioDeadlineMisses.setText(String(lround(deadlineMissMeter->rate_1min() * 60)),
+                                      NotificationType::dontSendNotification);
 
         auto netOut = bytesOutMeter->rate_1min();
         auto netIn = bytesInMeter->rate_1min();
@@ -222,6 +289,67 @@ StatisticsWindow::StatisticsWindow(App* app)
         }
         m_audioBytesOut.setText(String(netOut, 2) + dataUnitOut, NotificationType::dontSendNotification);
         m_audioBytesIn.setText(String(netIn, 2) + dataUnitIn, NotificationType::dontSendNotification);
+
+        // per plugin processing times, the most expensive plugins first
+        std::vector<std::pair<String, TimeStatistic::Histogram>> pluginTimes;
+        for (auto& s : Metrics::getStats()) {
+            if (s.first.startsWith(AGProcessor::DSP_STAT_PREFIX)) {
+                if (auto ts = std::dynamic_pointer_cast<TimeStatistic>(s.second)) {
+                    auto prefixLen = String(AGProcessor::DSP_STAT_PREFIX).length();
+                    auto parts = StringArray::fromTokens(s.first.substring(prefixLen), "|", "");
+                    pluginTimes.emplace_back(parts[1] + " (" + parts[0] + ")", ts->get1minHistogram());
+                }
+            }
+        }
+        std::sort(pluginTimes.begin(), pluginTimes.end(),
+                  [](const auto& a, const auto& b) { return a.second.avg > b.second.avg; });
+        for (size_t i = 0; i < (size_t)NUM_OF_PLUGIN_ROWS; i++) {
+            String name, times;
+            if (i < pluginTimes.size()) {
+                auto& hist = pluginTimes[i].second;
+                name = pluginTimes[i].first;
+                times << "avg " << String(hist.avg, 2) << ", 99th " << String(hist.nintyNinth, 2) << ", max "
+                      << String(hist.max, 2) << " ms";
+            }
+            m_pluginNames[i].setText(name, NotificationType::dontSendNotification);
+            m_pluginTimes[i].setText(times, NotificationType::dontSendNotification);
+        }
+
+        m_memResident.setText(MemoryInfo::toMBString(MemoryInfo::getResidentBytes()),
+                              NotificationType::dontSendNotification);
+        m_memPlugins.setText(MemoryInfo::toMBString(pluginMemGauge->get()), NotificationType::dontSendNotification);
+        int budgetMB = m_app->getServer().getMemoryBudgetMB();
+        m_memBudget.setText(budgetMB > 0 ? String(budgetMB) + " MB" : "unlimited",
+                            NotificationType::dontSendNotification);
+
+        // per plugin memory and the sum per client, the largest first
+        std::vector<std::pair<String, int64>> memUsage;
+        std::unordered_map<String, int64> clientMem;
+        for (auto& s : Metrics::getStats()) {
+            if (s.first.startsWith(AGProcessor::MEM_STAT_PREFIX)) {
+                if (auto g = std::dynamic_pointer_cast<Gauge>(s.second)) {
+                    auto prefixLen = String(AGProcessor::MEM_STAT_PREFIX).length();
+                    auto parts = StringArray::fromTokens(s.first.substring(prefixLen), "|", "");
+                    memUsage.emplace_back(parts[1] + " (" + parts[0] + ")", g->get());
+                    clientMem[parts[0]] += g->get();
+                }
+            }
+        }
+        if (clientMem.size() > 1) {
+            for (auto& c : clientMem) {
+                memUsage.emplace_back("Client " + c.first, c.second);
+            }
+        }
+        std::sort(memUsage.begin(), memUsage.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        for (size_t i = 0; i < (size_t)NUM_OF_PLUGIN_ROWS; i++) {
+            String name, size;
+            if (i < memUsage.size()) {
+                name = memUsage[i].first;
+                size = MemoryInfo::toMBString(memUsage[i].second);
+            }
+            m_memNames[i].setText(name, NotificationType::dontSendNotification);
+            m_memSizes[i].setText(size, NotificationType::dontSendNotification);
+        }
     });
     m_updater.startThread();
 
@@ -34,7 +34,12 @@ class StatisticsWindow : public DocumentWindow, public LogTag {
     std::vector<std::unique_ptr<Component>> m_components;
     Label m_cpu, m_totalWorkers, m_activeWorkers, m_totalAudioWorkers, m_activeAudioWorkers, m_totalScreenWorkers,
         m_activeScreenWorkers, m_processors, m_plugins, m_audioRPS, m_audioPTavg, m_audioPTmin, m_audioPTmax,
-        m_audioPT95th, m_audioBytesOut, m_audioBytesIn;
+        m_audioPT95th, m_audioDeadlineMisses, m_audioBytesOut, m_audioBytesIn, m_memResident, m_memPlugins,
+        m_memBudget;
+
+    static constexpr int NUM_OF_PLUGIN_ROWS = 8;
+    Label m_pluginNames[NUM_OF_PLUGIN_ROWS], m_pluginTimes[NUM_OF_PLUGIN_ROWS];
+    Label m_memNames[NUM_OF_PLUGIN_ROWS], m_memSizes[NUM_OF_PLUGIN_ROWS];
 
     class Updater : public Thread, public LogTagDelegate {
       public:
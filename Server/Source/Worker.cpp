@@ -11,6 +11,10 @@
 #include "NumberConversion.hpp"
 #include "App.hpp"
 #include "CPUInfo.hpp"
+#include "OverloadGovernor.hpp"
+#include "StateCache.hpp"
+#include "StateDelta.hpp"
+#include "ParameterSubscription.hpp"
 
 #ifdef JUCE_MAC
 #include <sys/socket.h>
@@ -21,10 +25,11 @@ namespace e47 {
 std::atomic_uint32_t Worker::count{0};
 std::atomic_uint32_t Worker::runCount{0};
 
-Worker::Worker(StreamingSocket* clnt)
+Worker::Worker(StreamingSocket* clnt, const String& clientHost)
     : Thread("Worker"),
       LogTag("worker"),
       m_client(clnt),
+      m_clientHost(clientHost.isNotEmpty() ? clientHost : clnt->getHostName()),
       m_audio(std::make_shared<AudioWorker>(this)),
       m_screen(std::make_shared<ScreenWorker>(this)),
       m_msgFactory(this) {
@@ -52,6 +57,8 @@ void Worker::run() {
     len = m_client->read(&cfg, sizeof(cfg), true);
     if (len > 0) {
         setLogTagExtra("client:" + String::toHexString(cfg.clientId));
+        m_audio->setLogTagSource(this);
+        m_screen->setLogTagSource(this);
 
         logln("  version                  = " << cfg.version);
         logln("  clientId                 = " << String::toHexString(cfg.clientId));
@@ -67,17 +74,29 @@ void Worker::run() {
             m_noPluginListFilter = cfg.isFlag(Handshake::NO_PLUGINLIST_FILTER);
         }
 
+        if (cfg.version >= 3) {
+            m_capabilities = cfg.capabilities & Handshake::CAP_ALL;
+            logln("  capabilities             = " << String::toHexString((int)cfg.capabilities));
+        }
+
+        // only report overload events, that happen from now on
+        auto governor = OverloadGovernor::getInstance();
+        if (nullptr != governor) {
+            m_overloadEventSeq = governor->getEventSeq();
+        }
+
         // start audio processing
         sock = std::make_unique<StreamingSocket>();
 #ifdef JUCE_MAC
         setsockopt(sock->getRawSocketHandle(), SOL_SOCKET, SO_NOSIGPIPE, nullptr, 0);
 #endif
-        if (sock->connect(m_client->getHostName(), cfg.clientPort)) {
+        if (sock->connect(m_clientHost, cfg.clientPort)) {
             m_audio->init(std::move(sock), cfg.channelsIn, cfg.channelsOut, cfg.rate, cfg.samplesPerBlock,
-                          cfg.doublePrecission);
+                          cfg.doublePrecission, hasCapability(Handshake::CAP_SILENT_CHANNELS));
             m_audio->startThread(Thread::realtimeAudioPriority);
+            m_audio->seedPluginPool(m_clientHost);
         } else {
-            logln("failed to establish audio connection to " << m_client->getHostName() << ":" << cfg.clientPort);
+            logln("failed to establish audio connection to " << m_clientHost << ":" << cfg.clientPort);
         }
 
         // start screen capturing
@@ -85,11 +104,18 @@ void Worker::run() {
 #ifdef JUCE_MAC
         setsockopt(sock->getRawSocketHandle(), SOL_SOCKET, SO_NOSIGPIPE, nullptr, 0);
 #endif
-        if (sock->connect(m_client->getHostName(), cfg.clientPort)) {
+        if (sock->connect(m_clientHost, cfg.clientPort)) {
             m_screen->init(std::move(sock));
             m_screen->startThread();
         } else {
-            logln("failed to establish screen connection to " << m_client->getHostName() << ":" << cfg.clientPort);
+            logln("failed to establish screen connection to " << m_clientHost << ":" << cfg.clientPort);
+        }
+
+        // old clients don't expect the capabilities
+        if (cfg.version >= 3) {
+            Message<Capabilities> msgCaps(this);
+            msgCaps.payload.setNumber((int)Handshake::CAP_ALL);
+            msgCaps.send(m_client.get());
         }
 
         // send list of plugins
@@ -155,6 +181,9 @@ void Worker::run() {
                     case GetAllParameterValues::Type:
                         handleMessage(Message<Any>::convert<GetAllParameterValues>(msg));
                         break;
+                    case Parameters::Type:
+                        handleMessage(Message<Any>::convert<Parameters>(msg));
+                        break;
                     case UpdateScreenCaptureArea::Type:
                         handleMessage(Message<Any>::convert<UpdateScreenCaptureArea>(msg));
                         break;
@@ -170,6 +199,36 @@ void Worker::run() {
                     case PluginList::Type:
                         handleMessage(Message<Any>::convert<PluginList>(msg));
                         break;
+                    case SetParallelBranch::Type:
+                        handleMessage(Message<Any>::convert<SetParallelBranch>(msg));
+                        break;
+                    case PluginStats::Type:
+                        handleMessage(Message<Any>::convert<PluginStats>(msg));
+                        break;
+                    case SetBus::Type:
+                        handleMessage(Message<Any>::convert<SetBus>(msg));
+                        break;
+                    case SetSidechain::Type:
+                        handleMessage(Message<Any>::convert<SetSidechain>(msg));
+                        break;
+                    case OverloadEvents::Type:
+                        handleMessage(Message<Any>::convert<OverloadEvents>(msg));
+                        break;
+                    case GetChangedPluginSettings::Type:
+                        handleMessage(Message<Any>::convert<GetChangedPluginSettings>(msg));
+                        break;
+                    case LoadChain::Type:
+                        handleMessage(Message<Any>::convert<LoadChain>(msg));
+                        break;
+                    case SubscribeParameters::Type:
+                        handleMessage(Message<Any>::convert<SubscribeParameters>(msg));
+                        break;
+                    case MouseEvents::Type:
+                        handleMessage(Message<Any>::convert<MouseEvents>(msg));
+                        break;
+                    case SetParallelDry::Type:
+                        handleMessage(Message<Any>::convert<SetParallelDry>(msg));
+                        break;
                     default:
                         logln("unknown message type " << msg->getType());
                 }
@@ -179,9 +238,10 @@ void Worker::run() {
             }
         }
     } else {
-        logln("handshake error with client " << m_client->getHostName());
+        logln("handshake error with client " << m_clientHost);
     }
     shutdown();
+    m_paramSubscription.reset();
     m_audio->waitForThreadToExit(-1);
     m_audio.reset();
     m_screen->waitForThreadToExit(-1);
@@ -215,7 +275,22 @@ void Worker::handleMessage(std::shared_ptr<Message<Quit>> /* msg */) {
 
 void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     traceScope();
-    auto id = pPLD(msg).getString();
+    m_audio->wakeUp();
+    json j;
+    String id;
+    if (hasCapability(Handshake::CAP_PARAMETER_CACHE)) {
+        j = pPLD(msg).getJson();
+        id = jsonGetValue(j, "id", String());
+    } else if (nullptr != pPLD(msg).data) {
+        // old clients send the plain id
+        id = String::fromUTF8(pPLD(msg).data, *pPLD(msg).size);
+    }
+    auto governor = OverloadGovernor::getInstance();
+    if (nullptr != governor && governor->isAddPluginRefused()) {
+        logln("refusing to add plugin " << id << ", the server is overloaded");
+        m_msgFactory.sendResult(m_client.get(), -1, "The server is overloaded, please try again later.");
+        return;
+    }
     logln("adding plugin " << id << "...");
     String err;
     bool success = m_audio->addPlugin(id, err);
@@ -232,16 +307,7 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     }
     logln("sending presets...");
     auto proc = m_audio->getProcessor(m_audio->getSize() - 1)->getPlugin();
-    String presets;
-    bool first = true;
-    for (int i = 0; i < proc->getNumPrograms(); i++) {
-        if (first) {
-            first = false;
-        } else {
-            presets << "|";
-        }
-        presets << proc->getProgramName(i);
-    }
+    auto presets = getPresets(proc);
     Message<Presets> msgPresets;
     msgPresets.payload.setString(presets);
     if (!msgPresets.send(m_client.get())) {
@@ -251,37 +317,13 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     }
     logln("...ok");
     logln("sending parameters...");
-    json jparams = json::array();
-    for (auto& param : proc->getParameters()) {
-        json jparam = {{"idx", param->getParameterIndex()},
-                       {"name", param->getName(32).toStdString()},
-                       {"defaultValue", param->getDefaultValue()},
-                       {"currentValue", param->getValue()},
-                       {"category", param->getCategory()},
-                       {"label", param->getLabel().toStdString()},
-                       {"numSteps", param->getNumSteps()},
-                       {"isBoolean", param->isBoolean()},
-                       {"isDiscrete", param->isDiscrete()},
-                       {"isMeta", param->isMetaParameter()},
-                       {"isOrientInv", param->isOrientationInverted()},
-                       {"minValue", param->getText(0.0f, 20).toStdString()},
-                       {"maxValue", param->getText(1.0f, 20).toStdString()}};
-        jparam["allValues"] = json::array();
-        for (auto& val : param->getAllValueStrings()) {
-            jparam["allValues"].push_back(val.toStdString());
-        }
-        if (jparam["allValues"].size() == 0 && param->isDiscrete() && param->getNumSteps() < 64) {
-            // try filling values manually
-            float step = 1.0f / (param->getNumSteps() - 1);
-            for (int i = 0; i < param->getNumSteps(); i++) {
-                auto val = param->getText(step * i, 32);
-                if (val.isEmpty()) {
-                    break;
-                }
-                jparam["allValues"].push_back(val.toStdString());
-            }
-        }
-        jparams.push_back(jparam);
+    auto jparams = getParameters(proc, jsonGetValue(j, "paramsVersion", String()));
+    if (!hasCapability(Handshake::CAP_PARAMETER_CACHE)) {
+        // old clients expect the plain metadata array
+        jparams = jparams["parameters"];
+    } else {
+        // allows the client to request the full metadata, if its cache misses
+        jparams["idx"] = m_audio->getSize() - 1;
     }
     Message<Parameters> msgParams(this);
     msgParams.payload.setJson(jparams);
@@ -292,24 +334,23 @@ void Worker::handleMessage(std::shared_ptr<Message<AddPlugin>> msg) {
     }
     logln("...ok");
     logln("reading plugin settings...");
-    Message<PluginSettings> msgSettings(this);
-    MessageHelper::Error e;
-    if (!msgSettings.read(m_client.get(), &e, 10000)) {
-        logln("failed to read PluginSettings message:" << e.toString());
+    MemoryBlock block;
+    if (!readPluginSettings(block)) {
         m_client->close();
         return;
     }
-    if (*msgSettings.payload.size > 0) {
-        MemoryBlock block;
-        block.append(msgSettings.payload.data, as<size_t>(*msgSettings.payload.size));
+    if (block.getSize() > 0) {
         proc->setStateInformation(block.getData(), static_cast<int>(block.getSize()));
     }
     logln("...ok");
-    m_audio->addToRecentsList(id, m_client->getHostName());
+    m_audio->addToRecentsList(id, m_clientHost);
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<DelPlugin>> msg) {
     traceScope();
+    m_audio->wakeUp();
+    // the subscribed plugin might be deleted or have a new index
+    m_paramSubscription.reset();
     m_audio->delPlugin(pPLD(msg).getNumber());
     // send new updated latency samples back
     m_msgFactory.sendResult(m_client.get(), m_audio->getLatencySamples());
@@ -317,6 +358,7 @@ void Worker::handleMessage(std::shared_ptr<Message<DelPlugin>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<EditPlugin>> msg) {
     traceScope();
+    m_audio->wakeUp();
     auto proc = m_audio->getProcessor(pPLD(msg).getNumber());
     if (nullptr != proc) {
         m_screen->showEditor(proc);
@@ -335,25 +377,47 @@ void Worker::handleMessage(std::shared_ptr<Message<Mouse>> msg) {
     auto ev = *pDATA(msg);
     runOnMsgThreadAsync([this, ev] {
         traceScope();
-        auto point = getApp()->localPointToGlobal(Point<float>(ev.x, ev.y));
-        if (ev.type == MouseEvType::WHEEL) {
-            mouseScrollEvent(point.x, point.y, ev.deltaX, ev.deltaY, ev.isSmooth);
-        } else {
-            uint64_t flags = 0;
-            if (ev.isShiftDown) {
-                setShiftKey(flags);
-            }
-            if (ev.isCtrlDown) {
-                setControlKey(flags);
-            }
-            if (ev.isAltDown) {
-                setAltKey(flags);
-            }
-            mouseEvent(ev.type, point.x, point.y, flags);
+        injectMouseEvent(ev);
+    });
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<MouseEvents>> msg) {
+    traceScope();
+    std::vector<mouseevent_t> events;
+    auto num = as<size_t>(*pPLD(msg).size) / sizeof(mouseevent_t);
+    if (num > 0) {
+        events.resize(num);
+        memcpy(events.data(), pPLD(msg).data, num * sizeof(mouseevent_t));
+    }
+    // inject the whole batch with a single message thread hop
+    runOnMsgThreadAsync([this, events] {
+        traceScope();
+        for (auto& ev : events) {
+            injectMouseEvent(ev);
         }
     });
 }
 
+void Worker::injectMouseEvent(const mouseevent_t& ev) {
+    traceScope();
+    auto point = getApp()->localPointToGlobal(Point<float>(ev.x, ev.y));
+    if (ev.type == MouseEvType::WHEEL) {
+        mouseScrollEvent(point.x, point.y, ev.deltaX, ev.deltaY, ev.isSmooth);
+    } else {
+        uint64_t flags = 0;
+        if (ev.isShiftDown) {
+            setShiftKey(flags);
+        }
+        if (ev.isCtrlDown) {
+            setControlKey(flags);
+        }
+        if (ev.isAltDown) {
+            setAltKey(flags);
+        }
+        mouseEvent(ev.type, point.x, point.y, flags);
+    }
+}
+
 void Worker::handleMessage(std::shared_ptr<Message<Key>> msg) {
     traceScope();
     runOnMsgThreadAsync([this, msg] {
@@ -384,6 +448,8 @@ void Worker::handleMessage(std::shared_ptr<Message<GetPluginSettings>> msg) {
     if (nullptr != proc) {
         MemoryBlock block;
         proc->getStateInformation(block);
+        // the client keeps these settings, so it can load them later by sending the hash
+        StateCache::add(PluginSettingsHash::calculate(block), block);
         Message<PluginSettings> ret(this);
         ret.payload.setData(block.begin(), static_cast<int>(block.getSize()));
         ret.send(m_client.get());
@@ -392,24 +458,22 @@ void Worker::handleMessage(std::shared_ptr<Message<GetPluginSettings>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<SetPluginSettings>> msg) {
     traceScope();
+    m_audio->wakeUp();
     auto proc = m_audio->getProcessor(pPLD(msg).getNumber());
-    if (nullptr != proc) {
-        Message<PluginSettings> msgSettings(this);
-        if (!msgSettings.read(m_client.get())) {
-            logln("failed to read PluginSettings message");
-            m_client->close();
-            return;
-        }
-        if (*msgSettings.payload.size > 0) {
-            MemoryBlock block;
-            block.append(msgSettings.payload.data, as<size_t>(*msgSettings.payload.size));
-            proc->setStateInformation(block.getData(), static_cast<int>(block.getSize()));
-        }
+    // the client sends the settings in any case
+    MemoryBlock block;
+    if (!readPluginSettings(block, proc)) {
+        m_client->close();
+        return;
+    }
+    if (nullptr != proc && block.getSize() > 0) {
+        proc->setStateInformation(block.getData(), static_cast<int>(block.getSize()));
     }
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<BypassPlugin>> msg) {
     traceScope();
+    m_audio->wakeUp();
     auto proc = m_audio->getProcessor(pPLD(msg).getNumber());
     if (nullptr != proc) {
         proc->suspendProcessing(true);
@@ -418,6 +482,7 @@ void Worker::handleMessage(std::shared_ptr<Message<BypassPlugin>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<UnbypassPlugin>> msg) {
     traceScope();
+    m_audio->wakeUp();
     auto proc = m_audio->getProcessor(pPLD(msg).getNumber());
     if (nullptr != proc) {
         proc->suspendProcessing(false);
@@ -426,18 +491,21 @@ void Worker::handleMessage(std::shared_ptr<Message<UnbypassPlugin>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<ExchangePlugins>> msg) {
     traceScope();
+    m_audio->wakeUp();
+    m_paramSubscription.reset();
     m_audio->exchangePlugins(pDATA(msg)->idxA, pDATA(msg)->idxB);
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<RecentsList>> msg) {
     traceScope();
-    auto list = m_audio->getRecentsList(m_client->getHostName());
+    auto list = m_audio->getRecentsList(m_clientHost);
     pPLD(msg).setString(list);
     msg->send(m_client.get());
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<Preset>> msg) {
     traceScope();
+    m_audio->wakeUp();
     auto p = m_audio->getProcessor(pDATA(msg)->idx)->getPlugin();
     if (nullptr != p) {
         p->setCurrentProgram(pDATA(msg)->preset);
@@ -446,19 +514,16 @@ void Worker::handleMessage(std::shared_ptr<Message<Preset>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<ParameterValue>> msg) {
     traceScope();
-    auto p = m_audio->getProcessor(pDATA(msg)->idx)->getPlugin();
-    if (nullptr != p) {
-        for (auto* param : p->getParameters()) {
-            if (pDATA(msg)->paramIdx == param->getParameterIndex()) {
-                param->setValue(pDATA(msg)->value);
-                return;
-            }
-        }
+    m_audio->wakeUp();
+    auto proc = m_audio->getProcessor(pDATA(msg)->idx);
+    if (nullptr != proc) {
+        proc->setParameterValue(pDATA(msg)->paramIdx, pDATA(msg)->value);
     }
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<GetParameterValue>> msg) {
     traceScope();
+    m_audio->wakeUp();
     Message<ParameterValue> ret(this);
     DATA(ret)->idx = pDATA(msg)->idx;
     DATA(ret)->paramIdx = pDATA(msg)->paramIdx;
@@ -468,16 +533,52 @@ void Worker::handleMessage(std::shared_ptr<Message<GetParameterValue>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<GetAllParameterValues>> msg) {
     traceScope();
-    auto p = m_audio->getProcessor(pPLD(msg).getNumber())->getPlugin();
+    m_audio->wakeUp();
+    auto proc = m_audio->getProcessor(pPLD(msg).getNumber());
+    auto p = nullptr != proc ? proc->getPlugin() : nullptr;
+    if (!hasCapability(Handshake::CAP_PARAMETER_VALUES)) {
+        // old clients expect a message per parameter
+        if (nullptr != p) {
+            for (auto* param : p->getParameters()) {
+                Message<ParameterValue> ret(this);
+                DATA(ret)->idx = pPLD(msg).getNumber();
+                DATA(ret)->paramIdx = param->getParameterIndex();
+                DATA(ret)->value = param->getValue();
+                ret.send(m_client.get());
+            }
+        }
+        return;
+    }
+    MemoryOutputStream out;
+    out.writeInt(pPLD(msg).getNumber());
     if (nullptr != p) {
         for (auto* param : p->getParameters()) {
-            Message<ParameterValue> ret(this);
-            DATA(ret)->idx = pPLD(msg).getNumber();
-            DATA(ret)->paramIdx = param->getParameterIndex();
-            DATA(ret)->value = param->getValue();
-            ret.send(m_client.get());
+            out.writeInt(param->getParameterIndex());
+            out.writeFloat(param->getValue());
         }
     }
+    // all values are sent with a single message
+    Message<ParameterValues> ret(this);
+    ret.payload.setData(static_cast<const char*>(out.getData()), static_cast<int>(out.getDataSize()));
+    ret.send(m_client.get());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<Parameters>> msg) {
+    traceScope();
+    m_audio->wakeUp();
+    auto j = pPLD(msg).getJson();
+    auto proc = m_audio->getProcessor(jsonGetValue(j, "idx", -1));
+    auto p = nullptr != proc ? proc->getPlugin() : nullptr;
+    json jparams;
+    if (nullptr != p) {
+        jparams = getParameters(p, jsonGetValue(j, "paramsVersion", String()));
+    } else {
+        jparams = {{"error", "invalid plugin index"}};
+    }
+    pPLD(msg).setJson(jparams);
+    if (!msg->send(m_client.get())) {
+        logln("failed to send Parameters message");
+    }
 }
 
 void Worker::handleMessage(std::shared_ptr<Message<UpdateScreenCaptureArea>> msg) {
@@ -487,6 +588,10 @@ void Worker::handleMessage(std::shared_ptr<Message<UpdateScreenCaptureArea>> msg
 
 void Worker::handleMessage(std::shared_ptr<Message<Rescan>> msg) {
     traceScope();
+    if (getApp()->getServer().isSandbox()) {
+        logln("ignoring rescan request in sandbox");
+        return;
+    }
     bool wipe = pPLD(msg).getNumber() == 1;
     runOnMsgThreadAsync([this, wipe] {
         traceScope();
@@ -500,6 +605,10 @@ void Worker::handleMessage(std::shared_ptr<Message<Rescan>> msg) {
 
 void Worker::handleMessage(std::shared_ptr<Message<Restart>> /*msg*/) {
     traceScope();
+    if (getApp()->getServer().isSandbox()) {
+        logln("ignoring restart request in sandbox");
+        return;
+    }
     runOnMsgThreadAsync([this] {
         traceScope();
         getApp()->prepareShutdown(App::EXIT_RESTART);
@@ -537,4 +646,356 @@ void Worker::handleMessage(std::shared_ptr<Message<PluginList>> msg) {
     msg->send(m_client.get());
 }
 
+void Worker::handleMessage(std::shared_ptr<Message<SetParallelBranch>> msg) {
+    traceScope();
+    m_audio->wakeUp();
+    m_audio->setParallelBranch(pDATA(msg)->idx, pDATA(msg)->group, pDATA(msg)->branch);
+    // send new updated latency samples back
+    m_msgFactory.sendResult(m_client.get(), m_audio->getLatencySamples());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<PluginStats>> msg) {
+    traceScope();
+    json jstats = json::array();
+    for (int i = 0; i < m_audio->getSize(); i++) {
+        AGProcessor::DSPStats stats;
+        auto proc = m_audio->getProcessor(i);
+        if (nullptr != proc) {
+            stats = proc->getDSPStats();
+        }
+        jstats.push_back({{"load", stats.load}, {"avg", stats.avg}, {"p99", stats.p99}, {"max", stats.max}});
+    }
+    pPLD(msg).setJson(jstats);
+    msg->send(m_client.get());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<SetBus>> msg) {
+    traceScope();
+    auto j = pPLD(msg).getJson();
+    m_audio->setBus(jsonGetValue(j, "send", String()), jsonGetValue(j, "return", String()));
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<SetSidechain>> msg) {
+    traceScope();
+    auto j = pPLD(msg).getJson();
+    m_audio->setSidechain(jsonGetValue(j, "publish", String()), jsonGetValue(j, "publishOutput", false),
+                          jsonGetValue(j, "source", String()));
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<OverloadEvents>> msg) {
+    traceScope();
+    json j = {{"level", 0}, {"events", json::array()}, {"bypassed", json::array()}};
+    auto governor = OverloadGovernor::getInstance();
+    if (nullptr != governor) {
+        j["level"] = governor->getLevel();
+        for (auto& e : governor->getEvents(m_overloadEventSeq)) {
+            j["events"].push_back(e.toStdString());
+        }
+    }
+    // the plugins of this chain, that the governor has bypassed
+    for (int i = 0; i < m_audio->getSize(); i++) {
+        auto proc = m_audio->getProcessor(i);
+        if (nullptr != proc && proc->isGovernorBypassed()) {
+            j["bypassed"].push_back(i);
+        }
+    }
+    pPLD(msg).setJson(j);
+    msg->send(m_client.get());
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<GetChangedPluginSettings>> msg) {
+    traceScope();
+    auto j = pPLD(msg).getJson();
+    auto proc = m_audio->getProcessor(jsonGetValue(j, "idx", -1));
+    MemoryBlock block;
+    if (nullptr != proc) {
+        proc->getStateInformation(block);
+    }
+    auto hash = PluginSettingsHash::calculate(block);
+    auto knownHash = jsonGetValue(j, "hash", String());
+    Message<PluginSettingsDelta> ret(this);
+    // unchanged settings are answered with an empty message
+    if (hash != knownHash) {
+        StateCache::add(hash, block);
+        // if the known settings dropped out of the cache, the delta contains the full settings
+        MemoryBlock basis;
+        StateCache::get(knownHash, basis);
+        auto delta = StateDelta::create(basis, block);
+        traceln("settings delta: " << (int)delta.getSize() << " of " << (int)block.getSize() << " bytes");
+        ret.payload.setData(delta.begin(), static_cast<int>(delta.getSize()));
+    }
+    ret.send(m_client.get());
+}
+
+bool Worker::readPluginSettings(MemoryBlock& block, std::shared_ptr<AGProcessor> proc) {
+    traceScope();
+    MessageHelper::Error e;
+    if (!hasCapability(Handshake::CAP_SETTINGS_HASH)) {
+        Message<PluginSettings> msgSettings(this);
+        if (!msgSettings.read(m_client.get(), &e, 10000)) {
+            logln("failed to read PluginSettings message: " << e.toString());
+            return false;
+        }
+        if (*msgSettings.payload.size > 0) {
+            block.append(msgSettings.payload.data, as<size_t>(*msgSettings.payload.size));
+        }
+        return true;
+    }
+    Message<PluginSettingsHash> msgHash(this);
+    if (!msgHash.read(m_client.get(), &e, 10000)) {
+        logln("failed to read PluginSettingsHash message: " << e.toString());
+        return false;
+    }
+    auto hash = msgHash.payload.getString();
+    if (hash.isEmpty()) {
+        // no settings
+        return true;
+    }
+    if (StateCache::get(hash, block)) {
+        traceln("settings " << hash << " found in cache");
+        return m_msgFactory.sendResult(m_client.get(), 1);
+    }
+    MemoryBlock basis;
+    if (nullptr != proc) {
+        proc->getStateInformation(basis);
+    }
+    if (!m_msgFactory.sendResult(m_client.get(), 0, PluginSettingsHash::calculate(basis))) {
+        logln("failed to request plugin settings");
+        return false;
+    }
+    Message<PluginSettingsDelta> msgDelta(this);
+    if (!msgDelta.read(m_client.get(), &e, 10000)) {
+        logln("failed to read PluginSettingsDelta message: " << e.toString());
+        return false;
+    }
+    MemoryBlock delta;
+    if (*msgDelta.payload.size > 0) {
+        delta.append(msgDelta.payload.data, as<size_t>(*msgDelta.payload.size));
+    }
+    if (!StateDelta::apply(basis, delta, block)) {
+        logln("failed to apply plugin settings delta");
+        return false;
+    }
+    // don't trust the announced hash for the cache key
+    StateCache::add(PluginSettingsHash::calculate(block), block);
+    return true;
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<LoadChain>> msg) {
+    traceScope();
+    m_audio->wakeUp();
+    auto j = pPLD(msg).getJson();
+    json reply = {{"missing", json::array()}};
+    auto governor = OverloadGovernor::getInstance();
+    if (nullptr != governor && governor->isAddPluginRefused()) {
+        logln("refusing to load chain, the server is overloaded");
+        reply["error"] = "The server is overloaded, please try again later.";
+        pPLD(msg).setJson(reply);
+        msg->send(m_client.get());
+        return;
+    }
+    StringArray ids, paramsVersions;
+    std::vector<MemoryBlock> settings;
+    for (auto& jplug : j["plugins"]) {
+        ids.add(jsonGetValue(jplug, "id", String()));
+        paramsVersions.add(jsonGetValue(jplug, "paramsVersion", String()));
+        settings.emplace_back();
+        auto hash = jsonGetValue(jplug, "hash", String());
+        if (hash.isNotEmpty() && !StateCache::get(hash, settings.back())) {
+            reply["missing"].push_back(ids.size() - 1);
+        }
+    }
+    pPLD(msg).setJson(reply);
+    if (!msg->send(m_client.get())) {
+        logln("failed to send LoadChain message");
+        m_client->close();
+        return;
+    }
+    logln("loading chain with " << ids.size() << " plugins...");
+    // load the plugins, while the client sends the missing settings
+    std::vector<std::shared_ptr<AGProcessor>> procs((size_t)ids.size());
+    std::vector<String> errors((size_t)ids.size());
+    std::deque<size_t> loaded;
+    std::mutex loadedMtx;
+    WaitableEvent loadedEvent;
+    m_audio->loadPlugins(ids, [&](size_t idx, std::shared_ptr<AGProcessor> proc, const String& err) {
+        std::lock_guard<std::mutex> lock(loadedMtx);
+        procs[idx] = proc;
+        errors[idx] = err;
+        loaded.push_back(idx);
+        loadedEvent.signal();
+    });
+    bool ok = true;
+    for (auto& jidx : reply["missing"]) {
+        auto idx = jidx.get<size_t>();
+        Message<PluginSettingsDelta> msgDelta(this);
+        MessageHelper::Error e;
+        if (!msgDelta.read(m_client.get(), &e, 10000)) {
+            logln("failed to read PluginSettingsDelta message: " << e.toString());
+            ok = false;
+            break;
+        }
+        MemoryBlock delta;
+        if (*msgDelta.payload.size > 0) {
+            delta.append(msgDelta.payload.data, as<size_t>(*msgDelta.payload.size));
+        }
+        if (!StateDelta::apply({}, delta, settings[idx])) {
+            logln("failed to apply plugin settings delta");
+            ok = false;
+            break;
+        }
+        StateCache::add(PluginSettingsHash::calculate(settings[idx]), settings[idx]);
+    }
+    // send the results in the order the loads finish, the loads reference the locals above, so we have to wait for
+    // all of them in any case
+    for (size_t done = 0; done < procs.size();) {
+        std::deque<size_t> batch;
+        {
+            std::lock_guard<std::mutex> lock(loadedMtx);
+            batch.swap(loaded);
+        }
+        if (batch.empty()) {
+            loadedEvent.wait();
+            continue;
+        }
+        for (auto i : batch) {
+            done++;
+            std::shared_ptr<AudioPluginInstance> proc;
+            String err;
+            {
+                std::lock_guard<std::mutex> lock(loadedMtx);
+                proc = nullptr != procs[i] ? procs[i]->getPlugin() : nullptr;
+                err = errors[i];
+            }
+            if (!ok) {
+                continue;
+            }
+            json jres = {{"idx", i}};
+            if (nullptr != proc) {
+                if (settings[i].getSize() > 0) {
+                    proc->setStateInformation(settings[i].getData(), static_cast<int>(settings[i].getSize()));
+                }
+                jres["presets"] = getPresets(proc).toStdString();
+                jres["parameters"] = getParameters(proc, paramsVersions[(int)i]);
+                m_audio->addToRecentsList(ids[(int)i], m_clientHost);
+                logln("..." << ids[(int)i] << " ok");
+            } else {
+                jres["error"] = err.toStdString();
+                logln("..." << ids[(int)i] << " failed: " << err);
+            }
+            Message<LoadChainResult> msgRes(this);
+            msgRes.payload.setJson(jres);
+            if (!msgRes.send(m_client.get())) {
+                logln("failed to send LoadChainResult message");
+                ok = false;
+            }
+        }
+    }
+    if (!ok) {
+        m_client->close();
+        return;
+    }
+    // the chain order is the order of the request
+    m_audio->addProcessors(procs);
+    // send new updated latency samples back
+    m_msgFactory.sendResult(m_client.get(), m_audio->getLatencySamples());
+}
+
+String Worker::getPresets(std::shared_ptr<AudioPluginInstance> proc) {
+    traceScope();
+    String presets;
+    bool first = true;
+    for (int i = 0; i < proc->getNumPrograms(); i++) {
+        if (first) {
+            first = false;
+        } else {
+            presets << "|";
+        }
+        presets << proc->getProgramName(i);
+    }
+    return presets;
+}
+
+String Worker::getParametersVersion(std::shared_ptr<AudioPluginInstance> proc) {
+    traceScope();
+    auto desc = proc->getPluginDescription();
+    String str;
+    str << desc.createIdentifierString() << "|" << desc.version << "|" << desc.lastFileModTime.toMilliseconds() << "|"
+        << proc->getParameters().size();
+    for (auto& param : proc->getParameters()) {
+        str << "|" << param->getName(32);
+    }
+    return String::toHexString(str.hashCode64());
+}
+
+json Worker::getParameters(std::shared_ptr<AudioPluginInstance> proc, const String& knownVersion) {
+    traceScope();
+    auto version = getParametersVersion(proc);
+    json j = {{"version", version.toStdString()}};
+    if (version == knownVersion) {
+        // the client has cached the metadata, the current values are enough
+        json jvalues = json::array();
+        for (auto& param : proc->getParameters()) {
+            jvalues.push_back(param->getValue());
+        }
+        j["values"] = jvalues;
+        return j;
+    }
+    json jparams = json::array();
+    for (auto& param : proc->getParameters()) {
+        json jparam = {{"idx", param->getParameterIndex()},
+                       {"name", param->getName(32).toStdString()},
+                       {"defaultValue", param->getDefaultValue()},
+                       {"currentValue", param->getValue()},
+                       {"category", param->getCategory()},
+                       {"label", param->getLabel().toStdString()},
+                       {"numSteps", param->getNumSteps()},
+                       {"isBoolean", param->isBoolean()},
+                       {"isDiscrete", param->isDiscrete()},
+                       {"isMeta", param->isMetaParameter()},
+                       {"isOrientInv", param->isOrientationInverted()},
+                       {"minValue", param->getText(0.0f, 20).toStdString()},
+                       {"maxValue", param->getText(1.0f, 20).toStdString()}};
+        jparam["allValues"] = json::array();
+        for (auto& val : param->getAllValueStrings()) {
+            jparam["allValues"].push_back(val.toStdString());
+        }
+        if (jparam["allValues"].size() == 0 && param->isDiscrete() && param->getNumSteps() < 64) {
+            // try filling values manually
+            float step = 1.0f / (param->getNumSteps() - 1);
+            for (int i = 0; i < param->getNumSteps(); i++) {
+                auto val = param->getText(step * i, 32);
+                if (val.isEmpty()) {
+                    break;
+                }
+                jparam["allValues"].push_back(val.toStdString());
+            }
+        }
+        jparams.push_back(jparam);
+    }
+    j["parameters"] = jparams;
+    return j;
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<SubscribeParameters>> msg) {
+    traceScope();
+    m_paramSubscription.reset();
+    int idx = pPLD(msg).getNumber();
+    if (idx < 0) {
+        return;
+    }
+    auto proc = m_audio->getProcessor(idx);
+    if (nullptr != proc && nullptr != proc->getPlugin()) {
+        m_paramSubscription = std::make_unique<ParameterSubscription>(this, idx, proc, m_screen);
+    }
+}
+
+void Worker::handleMessage(std::shared_ptr<Message<SetParallelDry>> msg) {
+    traceScope();
+    m_audio->wakeUp();
+    m_audio->setParallelDry(pDATA(msg)->group, pDATA(msg)->dry);
+    // send new updated latency samples back
+    m_msgFactory.sendResult(m_client.get(), m_audio->getLatencySamples());
+}
+
 }  // namespace e47
@@ -14,6 +14,7 @@
 #include "AudioWorker.hpp"
 #include "Message.hpp"
 #include "ScreenWorker.hpp"
+#include "ParameterSubscription.hpp"
 #include "Utils.hpp"
 
 namespace e47 {
@@ -25,7 +26,7 @@ class Worker : public Thread, public LogTag {
     static std::atomic_uint32_t count;
     static std::atomic_uint32_t runCount;
 
-    Worker(StreamingSocket* clnt);
+    Worker(StreamingSocket* clnt, const String& clientHost = {});
     ~Worker() override;
     void run() override;
 
@@ -48,22 +49,57 @@ class Worker : public Thread, public LogTag {
     void handleMessage(std::shared_ptr<Message<ParameterValue>> msg);
     void handleMessage(std::shared_ptr<Message<GetParameterValue>> msg);
     void handleMessage(std::shared_ptr<Message<GetAllParameterValues>> msg);
+    void handleMessage(std::shared_ptr<Message<Parameters>> msg);
     void handleMessage(std::shared_ptr<Message<UpdateScreenCaptureArea>> msg);
     void handleMessage(std::shared_ptr<Message<Rescan>> msg);
     void handleMessage(std::shared_ptr<Message<Restart>> msg);
     void handleMessage(std::shared_ptr<Message<CPULoad>> msg);
     void handleMessage(std::shared_ptr<Message<PluginList>> msg);
+    void handleMessage(std::shared_ptr<Message<SetParallelBranch>> msg);
+    void handleMessage(std::shared_ptr<Message<PluginStats>> msg);
+    void handleMessage(std::shared_ptr<Message<SetBus>> msg);
+    void handleMessage(std::shared_ptr<Message<SetSidechain>> msg);
+    void handleMessage(std::shared_ptr<Message<OverloadEvents>> msg);
+    void handleMessage(std::shared_ptr<Message<GetChangedPluginSettings>> msg);
+    void handleMessage(std::shared_ptr<Message<LoadChain>> msg);
+    void handleMessage(std::shared_ptr<Message<SubscribeParameters>> msg);
+    void handleMessage(std::shared_ptr<Message<MouseEvents>> msg);
+    void handleMessage(std::shared_ptr<Message<SetParallelDry>> msg);
 
   private:
     std::unique_ptr<StreamingSocket> m_client;
+    // the host to connect back to, differs from the host of the command connection when running in a sandbox
+    String m_clientHost;
     std::shared_ptr<AudioWorker> m_audio;
     std::shared_ptr<ScreenWorker> m_screen;
+    std::unique_ptr<ParameterSubscription> m_paramSubscription;
     bool m_shouldHideEditor = false;
     std::atomic_bool m_shutdown{false};
     MessageFactory m_msgFactory;
 
     bool m_noPluginListFilter = false;
 
+    // the protocol extensions, that the client supports (see Handshake::CAPABILITIES)
+    uint32 m_capabilities = 0;
+    bool hasCapability(uint32 cap) const { return (m_capabilities & cap) == cap; }
+
+    // the last overload event, that has been sent to the client
+    uint64 m_overloadEventSeq = 0;
+
+    // Reads plugin settings announced by their hash, the settings data is transferred only if the hash is unknown.
+    // In this case the current settings of the given processor are offered as basis for a delta.
+    bool readPluginSettings(MemoryBlock& block, std::shared_ptr<AGProcessor> proc = nullptr);
+
+    void injectMouseEvent(const mouseevent_t& ev);
+
+    String getPresets(std::shared_ptr<AudioPluginInstance> proc);
+
+    // Identifies the parameter metadata of a plugin, clients cache the metadata by this version
+    String getParametersVersion(std::shared_ptr<AudioPluginInstance> proc);
+
+    // Returns the parameter metadata or only the current values, if the client knows the version already
+    json getParameters(std::shared_ptr<AudioPluginInstance> proc, const String& knownVersion = {});
+
     ENABLE_ASYNC_FUNCTORS();
 };
 
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+#include <JuceHeader.h>
+
+#include <cstdlib>
+
+namespace e47 {
+
+/*
+ * Pass through effect, that aborts the hosting process as soon as its "Crash" parameter gets set. Used to test the
+ * crash isolation of the server sandbox mode.
+ */
+class CrashTestProcessor : public AudioProcessor {
+  public:
+    CrashTestProcessor()
+        : AudioProcessor(BusesProperties()
+                             .withInput("Input", AudioChannelSet::stereo(), true)
+                             .withOutput("Output", AudioChannelSet::stereo(), true)) {
+        addParameter(m_crash = new AudioParameterBool("crash", "Crash", false));
+    }
+
+    const String getName() const override { return "AGCrashTest"; }
+    bool acceptsMidi() const override { return false; }
+    bool producesMidi() const override { return false; }
+    double getTailLengthSeconds() const override { return 0.0; }
+
+    int getNumPrograms() override { return 1; }
+    int getCurrentProgram() override { return 0; }
+    void setCurrentProgram(int) override {}
+    const String getProgramName(int) override { return {}; }
+    void changeProgramName(int, const String&) override {}
+
+    void prepareToPlay(double, int) override {}
+    void releaseResources() override {}
+
+    void processBlock(AudioBuffer<float>&, MidiBuffer&) override {
+        if (m_crash->get()) {
+            std::abort();
+        }
+    }
+
+    bool hasEditor() const override { return false; }
+    AudioProcessorEditor* createEditor() override { return nullptr; }
+
+    void getStateInformation(MemoryBlock&) override {}
+    void setStateInformation(const void*, int) override {}
+
+  private:
+    AudioParameterBool* m_crash;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CrashTestProcessor)
+};
+
+}  // namespace e47
+
+AudioProcessor* JUCE_CALLTYPE createPluginFilter() { return new e47::CrashTestProcessor(); }
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2020 Andreas Pohl
+ * Licensed under MIT (https://github.com/apohl79/audiogridder/blob/master/COPYING)
+ *
+ * Author: Andreas Pohl
+ */
+
+/*
+ * Connects two clients to a server running in sandbox mode, loads the AGCrashTest plugin into both chains and
+ * crashes the first one. The test passes, if the connection of the crashed client gets closed while the second
+ * client keeps streaming audio and talking to its worker.
+ *
+ * Usage: SandboxTest [host] [port]
+ */
+
+#include <JuceHeader.h>
+
+#include "Defaults.hpp"
+#include "Message.hpp"
+
+using namespace e47;
+
+namespace {
+
+constexpr int CHANNELS = 2;
+constexpr int SAMPLES = 512;
+constexpr double RATE = 48000.0;
+constexpr int CONNECT_TIMEOUT = 60000;
+constexpr int BLOCKS_BEFORE_CRASH = 50;
+constexpr int BLOCKS_AFTER_CRASH = 200;
+constexpr int MAX_BLOCKS = 1000;
+
+class TestClient : public LogTag {
+  public:
+    TestClient(const String& name) : LogTag(name), m_msgFactory(this) {
+        m_bytesMeter = Metrics::getStatistic<Meter>("SandboxTestBytes");
+        m_buffer.setSize(CHANNELS, SAMPLES);
+        m_posInfo.resetToDefault();
+    }
+
+    bool connect(const String& host, int port, uint64 clientId) {
+        // the server might still be scanning plugins, so keep trying for a while
+        auto timeout = Time::getMillisecondCounter() + CONNECT_TIMEOUT;
+        while (!m_cmd.connect(host, port, 1000)) {
+            if (Time::getMillisecondCounter() > timeout) {
+                return fail("connection to server failed");
+            }
+            Thread::sleep(500);
+        }
+        int clientPort = 0;
+        for (int retry = 0; retry < 200; retry++) {
+            if (m_listener.createListener(Defaults::CLIENT_PORT - retry)) {
+                clientPort = Defaults::CLIENT_PORT - retry;
+                break;
+            }
+        }
+        if (clientPort == 0) {
+            return fail("failed to create listener");
+        }
+        Handshake cfg = {Handshake::VERSION, clientPort, CHANNELS, CHANNELS, RATE, SAMPLES, false, clientId};
+        cfg.capabilities = Handshake::CAP_ALL;
+        if (!e47::send(&m_cmd, reinterpret_cast<const char*>(&cfg), sizeof(cfg))) {
+            return fail("failed to send handshake");
+        }
+        m_audio.reset(accept());
+        if (nullptr == m_audio) {
+            return fail("no audio connection");
+        }
+        m_screen.reset(accept());
+        if (nullptr == m_screen) {
+            return fail("no screen connection");
+        }
+        MessageHelper::Error e;
+        Message<Capabilities> msgCaps(this);
+        if (!msgCaps.read(&m_cmd, &e, 10000)) {
+            return fail("failed to read capabilities: " + e.toString());
+        }
+        Message<PluginList> msgList(this);
+        if (!msgList.read(&m_cmd, &e, 10000)) {
+            return fail("failed to read plugin list: " + e.toString());
+        }
+        m_pluginList = StringArray::fromLines(msgList.payload.getString());
+        return true;
+    }
+
+    bool addPlugin(const String& name) {
+        String id;
+        for (auto& line : m_pluginList) {
+            if (line.isNotEmpty()) {
+                try {
+                    auto j = json::parse(line.toStdString());
+                    if (name == String(j["name"].get<std::string>())) {
+                        id = j["id"].get<std::string>();
+                        break;
+                    }
+                } catch (json::exception&) {
+                }
+            }
+        }
+        if (id.isEmpty()) {
+            return fail("plugin " + name + " not found, is it in the VST3 search path of the server?");
+        }
+        MessageHelper::Error e;
+        Message<AddPlugin> msg(this);
+        PLD(msg).setJson({{"id", id.toStdString()}, {"paramsVersion", ""}});
+        if (!msg.send(&m_cmd)) {
+            return fail("failed to send AddPlugin");
+        }
+        auto result = m_msgFactory.getResult(&m_cmd, 30, &e);
+        if (nullptr == result) {
+            return fail("failed to get result: " + e.toString());
+        }
+        if (result->getReturnCode() < 0) {
+            return fail("failed to add plugin: " + result->getString());
+        }
+        Message<Presets> msgPresets(this);
+        if (!msgPresets.read(&m_cmd, &e, 10000)) {
+            return fail("failed to read presets: " + e.toString());
+        }
+        Message<Parameters> msgParams(this);
+        if (!msgParams.read(&m_cmd, &e, 10000)) {
+            return fail("failed to read parameters: " + e.toString());
+        }
+        // no settings
+        Message<PluginSettingsHash> msgHash(this);
+        msgHash.payload.setString("");
+        if (!msgHash.send(&m_cmd)) {
+            return fail("failed to send settings hash");
+        }
+        return true;
+    }
+
+    bool process() {
+        for (int chan = 0; chan < CHANNELS; chan++) {
+            for (int i = 0; i < SAMPLES; i++) {
+                m_buffer.setSample(chan, i, (float)std::sin(m_phase + 0.1 * i) * 0.5f);
+            }
+        }
+        m_phase += 0.1 * SAMPLES;
+        m_midi.clear();
+        MessageHelper::Error e;
+        AudioMessage msg(this);
+        if (!msg.sendToServer(m_audio.get(), m_buffer, m_midi, m_posInfo, CHANNELS, SAMPLES, 0.0f, &e,
+                              *m_bytesMeter) ||
+            !msg.readFromServer(m_audio.get(), m_buffer, m_midi, &e, *m_bytesMeter)) {
+            m_lastError = e.toString();
+            return false;
+        }
+        return true;
+    }
+
+    bool setParameter(int paramIdx, float value) {
+        Message<ParameterValue> msg(this);
+        DATA(msg)->idx = 0;
+        DATA(msg)->paramIdx = paramIdx;
+        DATA(msg)->value = value;
+        return msg.send(&m_cmd);
+    }
+
+    bool getParameter(int paramIdx, float& value) {
+        Message<GetParameterValue> msg(this);
+        DATA(msg)->idx = 0;
+        DATA(msg)->paramIdx = paramIdx;
+        if (!msg.send(&m_cmd)) {
+            return fail("failed to send GetParameterValue");
+        }
+        MessageHelper::Error e;
+        Message<ParameterValue> ret(this);
+        if (!ret.read(&m_cmd, &e, 5000)) {
+            return fail("failed to read ParameterValue: " + e.toString());
+        }
+        value = DATA(ret)->value;
+        return true;
+    }
+
+    void close() {
+        Message<Quit> msg(this);
+        msg.send(&m_cmd);
+        m_cmd.close();
+        if (nullptr != m_audio) {
+            m_audio->close();
+        }
+        if (nullptr != m_screen) {
+            m_screen->close();
+        }
+    }
+
+    const String& getLastError() const { return m_lastError; }
+
+  private:
+    StreamingSocket m_cmd;
+    StreamingSocket m_listener;
+    std::unique_ptr<StreamingSocket> m_audio;
+    std::unique_ptr<StreamingSocket> m_screen;
+    MessageFactory m_msgFactory;
+    StringArray m_pluginList;
+    std::shared_ptr<Meter> m_bytesMeter;
+    AudioBuffer<float> m_buffer;
+    MidiBuffer m_midi;
+    AudioPlayHead::CurrentPositionInfo m_posInfo;
+    double m_phase = 0.0;
+    String m_lastError;
+
+    StreamingSocket* accept() {
+        if (m_listener.waitUntilReady(true, 10000) <= 0) {
+            return nullptr;
+        }
+        return m_listener.waitForNextConnection();
+    }
+
+    bool fail(const String& err) {
+        m_lastError = err;
+        return false;
+    }
+};
+
+int fail(const TestClient& c, const String& what) {
+    std::cerr << "[" << c.getLogTag() << "] FAILED: " << what;
+    if (c.getLastError().isNotEmpty()) {
+        std::cerr << ": " << c.getLastError();
+    }
+    std::cerr << std::endl;
+    return 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    String host = argc > 1 ? argv[1] : "127.0.0.1";
+    int port = argc > 2 ? String(argv[2]).getIntValue() : Defaults::SERVER_PORT;
+
+    TestClient victim("victim"), survivor("survivor");
+
+    if (!victim.connect(host, port, 1)) {
+        return fail(victim, "connect");
+    }
+    if (!survivor.connect(host, port, 2)) {
+        return fail(survivor, "connect");
+    }
+    if (!victim.addPlugin("AGCrashTest")) {
+        return fail(victim, "add plugin");
+    }
+    if (!survivor.addPlugin("AGCrashTest")) {
+        return fail(survivor, "add plugin");
+    }
+
+    for (int i = 0; i < BLOCKS_BEFORE_CRASH; i++) {
+        if (!victim.process()) {
+            return fail(victim, "process");
+        }
+        if (!survivor.process()) {
+            return fail(survivor, "process");
+        }
+    }
+    std::cout << "both chains are streaming, crashing the victim" << std::endl;
+
+    if (!victim.setParameter(0, 1.0f)) {
+        return fail(victim, "set crash parameter");
+    }
+
+    bool victimAlive = true;
+    int blocksAfterCrash = 0;
+    for (int i = 0; i < MAX_BLOCKS && blocksAfterCrash < BLOCKS_AFTER_CRASH; i++) {
+        if (victimAlive) {
+            victimAlive = victim.process();
+            if (!victimAlive) {
+                std::cout << "victim connection closed: " << victim.getLastError() << std::endl;
+            }
+        } else {
+            blocksAfterCrash++;
+        }
+        if (!survivor.process()) {
+            return fail(survivor, "process after the crash of the victim");
+        }
+    }
+    if (victimAlive) {
+        return fail(victim, "the plugin did not crash the sandbox");
+    }
+
+    float value = 1.0f;
+    if (!survivor.getParameter(0, value)) {
+        return fail(survivor, "command connection after the crash of the victim");
+    }
+    if (value != 0.0f) {
+        return fail(survivor, "unexpected parameter value " + String(value));
+    }
+
+    survivor.close();
+    victim.close();
+
+    std::cout << "OK: the survivor processed " << blocksAfterCrash << " blocks after the victim crashed" << std::endl;
+    return 0;
+}
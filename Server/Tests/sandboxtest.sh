@@ -0,0 +1,45 @@
+#!/bin/bash
+#
+# Runs the sandbox crash test against a server with sandbox mode enabled.
+#
+# Usage: sandboxtest.sh <server binary> <SandboxTest binary> <directory containing AGCrashTest.vst3> [server id]
+#
+# The server runs with a temporary home directory, so the config and plugin cache of the user are not touched.
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 <server binary> <test binary> <plugin dir> [server id]"
+    exit 1
+fi
+
+SERVER=$1
+TEST=$2
+PLUGINDIR=$3
+SRVID=${4:-9}
+PORT=$((55056 + SRVID))
+
+export HOME=$(mktemp -d)
+mkdir -p $HOME/.audiogridder
+cat > $HOME/.audiogridder/audiogridderserver.cfg <<EOF
+{
+    "ID": $SRVID,
+    "SandboxMode": true,
+    "ScanForPlugins": true,
+    "ScreenCapturingOff": true,
+    "VST": true,
+    "VST2": false,
+    "VST3Folders": ["$PLUGINDIR"],
+    "VSTNoStandardFolders": true
+}
+EOF
+
+"$SERVER" -server -id $SRVID &
+SRVPID=$!
+
+"$TEST" 127.0.0.1 $PORT
+RET=$?
+
+kill $SRVPID
+wait $SRVPID 2>/dev/null
+rm -rf $HOME
+
+exit $RET